@@ -3,13 +3,14 @@
 layout (location = 0) in vec2 textureCoordsIn;
 layout (location = 1) in flat int renderOptions;
 layout (location = 2) in flat int materialIdx;
+layout (location = 3) in flat int atlasIdx;
 
 // Output
 layout (location = 0) out vec4 fragColor;
 
 // Bindings, binding = 0 binds to GL_TEXTURE0, binding = 1 binds to GL_TEXTURE1, etc.
-layout (binding = 0) uniform sampler2D textureAtlas;
-layout (binding = 1) uniform sampler2D fontAtlas;
+layout (binding = FONT_TEXTURE_UNIT) uniform sampler2D fontAtlas;
+layout (binding = ATLAS_TEXTURE_UNIT) uniform sampler2D textureAtlases[MAX_ATLASES];
 
 // Input Buffers
 layout(std430, binding = 1) buffer Materials
@@ -17,6 +18,19 @@ layout(std430, binding = 1) buffer Materials
   Material materials[];
 };
 
+// Sampler arrays can only be indexed with the same value for the whole draw,
+// every Transform picks it's own Atlas, so the indices have to be constant
+vec4 fetch_atlas(ivec2 textureCoords)
+{
+  switch(atlasIdx)
+  {
+    case 1: return texelFetch(textureAtlases[1], textureCoords, 0);
+    case 2: return texelFetch(textureAtlases[2], textureCoords, 0);
+    case 3: return texelFetch(textureAtlases[3], textureCoords, 0);
+    default: return texelFetch(textureAtlases[0], textureCoords, 0);
+  }
+}
+
 void main()
 {
   Material material = materials[materialIdx];
@@ -34,7 +48,7 @@ void main()
   }
   else
   {
-    vec4 textureColor = texelFetch(textureAtlas, ivec2(textureCoordsIn), 0);
+    vec4 textureColor = fetch_atlas(ivec2(textureCoordsIn));
 
     if(textureColor.a == 0.0)
     {
@@ -5,6 +5,7 @@
 layout (location = 0) out vec2 textureCoordsOut;
 layout (location = 1) out flat int renderOptions;
 layout (location = 2) out flat int materialIdx;
+layout (location = 3) out flat int atlasIdx;
 
 // Buffers
 layout (std430, binding = 0) buffer TransformSBO
@@ -12,8 +13,12 @@ layout (std430, binding = 0) buffer TransformSBO
   Transform transforms[];
 };
 
+layout (std140, binding = 0) uniform CameraUBO
+{
+  Camera cameras[MAX_CAMERAS];
+};
+
 uniform vec2 screenSize;
-uniform mat4 orthoProjection;
 
 
 void main()
@@ -70,12 +75,28 @@ void main()
     vec2 vertexPos = vertices[gl_VertexID];
     // vertexPos.y = -vertexPos.y + screenSize.y;
     // vertexPos = 2.0 * (vertexPos / screenSize) - 1.0;
-    gl_Position = orthoProjection * vec4(vertexPos, transform.layer, 1.0);
+    Camera camera = cameras[transform.cameraIdx];
+    vec4 clipPos = camera.viewProjection * vec4(vertexPos, transform.layer, 1.0);
+
+    // Clip against the view of the Camera, otherwise a Minimap would 
+    // draw outside of it's viewport
+    gl_ClipDistance[0] = clipPos.w + clipPos.x;
+    gl_ClipDistance[1] = clipPos.w - clipPos.x;
+    gl_ClipDistance[2] = clipPos.w + clipPos.y;
+    gl_ClipDistance[3] = clipPos.w - clipPos.y;
+
+    // Move [-1; 1] into the viewport of the Camera
+    vec4 viewport = camera.viewport;
+    clipPos.x = (viewport.x * 2.0 - 1.0 + viewport.z) * clipPos.w + clipPos.x * viewport.z;
+    clipPos.y = (1.0 - viewport.y * 2.0 - viewport.w) * clipPos.w + clipPos.y * viewport.w;
+
+    gl_Position = clipPos;
   }
 
   textureCoordsOut = textureCoords[gl_VertexID];
   renderOptions = transform.renderOptions;
   materialIdx = transform.materialIdx;
+  atlasIdx = transform.atlasIdx;
 }
 
 
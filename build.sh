@@ -6,10 +6,23 @@ includes="-Ithird_party -Ithird_party/Include"
 
 timestamp=$(date +%s)
 
+# The Cooker turns the source assets into data the game uses directly,
+# has to run before the game is built, it generates src/sprite_table.h
+# and packs the runtime assets into assets.pak
+if [[ "$(uname)" == "Linux" ]]; then
+    cookerFile=cooker
+    cookerLibs="-lpthread"
+else
+    cookerFile=cooker.exe
+fi
+clang++ $includes -g src/cooker.cpp -o $cookerFile $warnings $defines $cookerLibs
+./$cookerFile || exit 1
+
 if [[ "$(uname)" == "Linux" ]]; then
     echo "Running on Linux"
-    libs="-lX11 -lGL -lfreetype"
+    libs="-lX11 -lGL -lfreetype -lpthread"
     outputFile=schnitzel
+    testSuffix=""
 
     # fPIC position independent code https://stackoverflow.com/questions/5311515/gcc-fpic-option
     rm -f game_* # Remove old game_* files
@@ -23,6 +36,7 @@ else
     echo "Running on Windows"
     libs="-luser32 -lopengl32 -lgdi32 -lole32 -Lthird_party/lib -lfreetype.lib"
     outputFile=schnitzel.exe
+    testSuffix=".exe"
 
     rm -f game_* # Remove old game_* files
     clang++ -g "src/game.cpp" -shared -o game_$timestamp.dll $warnings $defines
@@ -30,4 +44,21 @@ else
 fi
 
 
-clang++ $includes -g src/main.cpp -o$outputFile $libs $warnings $defines
\ No newline at end of file
+clang++ $includes -g src/main.cpp -o$outputFile $libs $warnings $defines
+
+# ./build.sh tests also builds the Tests and Benchmarks, every file in tests/
+# is its own program, built with optimizations into tests/bin and run by hand
+# from the repository root. The ones including tests/engine_harness.h open a
+# Window and read the assets.pak the Cooker wrote above
+if [[ "$1" == "tests" ]]; then
+    mkdir -p tests/bin
+    for testFile in tests/*.cpp; do
+        testName=$(basename $testFile .cpp)
+        clang++ $includes -Isrc -O2 -g $testFile -o tests/bin/$testName$testSuffix $libs $warnings $defines || exit 1
+    done
+
+    # The Rings are lock free, ThreadSanitizer checks them in a second build
+    if [[ "$(uname)" == "Linux" ]]; then
+        clang++ $includes -Isrc -O1 -g -fsanitize=thread tests/ring_stress_test.cpp -o tests/bin/ring_stress_test_tsan $libs $warnings $defines || exit 1
+    fi
+fi
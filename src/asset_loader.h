@@ -0,0 +1,372 @@
+#pragma once
+
+#include "schnitzel_lib.h"
+#include "platform.h"
+#include "asset_pack.h"
+
+// #############################################################################
+//                           Asset Loader Constants
+// #############################################################################
+// Also the size of the upload queue, has to be a power of 2
+constexpr int MAX_ASSETS = 64;
+constexpr int MAX_ASSET_PATH_LENGTH = 256;
+
+// Time the main thread spends finalizing Assets per frame, one is always finalized
+constexpr long long ASSET_UPLOAD_BUDGET_NS = 2000000;
+
+// #############################################################################
+//                           Asset Loader Structs
+// #############################################################################
+enum AssetType
+{
+  ASSET_TYPE_TEXTURE,
+  ASSET_TYPE_FONT,
+  ASSET_TYPE_SOUND,
+
+  ASSET_TYPE_COUNT
+};
+
+enum AssetState
+{
+  ASSET_STATE_UNLOADED,
+  ASSET_STATE_DECODING, // On a Worker
+  ASSET_STATE_DECODED,  // Waiting for the main thread, also after a failed decode
+  ASSET_STATE_LOADED,
+  ASSET_STATE_FAILED
+};
+
+// Index into the Assets, stays valid until the game closes
+typedef int AssetHandle;
+constexpr AssetHandle INVALID_ASSET_HANDLE = -1;
+
+struct Asset
+{
+  AssetType type;
+  char path[MAX_ASSET_PATH_LENGTH];
+  int param; // Font size for Fonts, index into allocatedSounds for Sounds
+
+  std::atomic<int> state;
+  // Main thread only, a reload that came in while the Asset was busy
+  bool reloadPending;
+  // Set by reload_asset(), the changed loose file is read instead of the Asset Pack
+  bool loose;
+  Job job;
+
+  // Written by the Worker, used up by the main thread
+  AssetFile file;
+  void* decoded; // malloc'd, freed once the Asset is finalized
+  long long decodeNs;
+  bool decodeFailed;
+
+  // Written by the main thread
+  unsigned int textureID;
+  int size; // VRAM or mapped bytes
+};
+
+/*
+* Assets are decoded on the Job Workers, the main thread only finalizes
+* them, e.g. uploads them to the GPU, within a budget every frame
+*/
+struct AssetLoader
+{
+  // Main thread only
+  int assetCount;
+  Asset assets[MAX_ASSETS];
+
+  // Every decode Job counts here, shutdown waits for it
+  JobCounter jobCounter;
+
+  // Decoded Assets, Workers -> main thread
+  MPSCRing<int, MAX_ASSETS> decodedAssets;
+};
+
+// #############################################################################
+//                           Asset Loader Globals
+// #############################################################################
+static AssetLoader assetLoader;
+
+// #############################################################################
+//                           Asset Loader Functions
+// #############################################################################
+// Run on a Worker, they fill in file or decoded and clean up after themselves on failure
+bool decode_texture_asset(Asset* asset); // gl_renderer.cpp
+bool decode_font_asset(Asset* asset);    // gl_renderer.cpp
+bool decode_sound_asset(Asset* asset);   // sound_loader.h
+
+// Run on the main thread, after a successful decode
+bool finalize_texture_asset(Asset* asset); // gl_renderer.cpp
+bool finalize_font_asset(Asset* asset);    // gl_renderer.cpp
+bool finalize_sound_asset(Asset* asset);   // sound_loader.h
+
+// Run on the main thread, releases what finalize created
+void unload_texture_asset(Asset* asset); // gl_renderer.cpp
+
+void decode_asset_job(void* data)
+{
+  Asset* asset = (Asset*)data;
+  long long startTime = platform_get_time_ns();
+
+  bool decoded = false;
+  switch(asset->type)
+  {
+    case ASSET_TYPE_TEXTURE: decoded = decode_texture_asset(asset); break;
+    case ASSET_TYPE_FONT:    decoded = decode_font_asset(asset);    break;
+    case ASSET_TYPE_SOUND:   decoded = decode_sound_asset(asset);   break;
+    default: SM_ASSERT(false, "Unknown Asset Type: %d", asset->type);
+  }
+  asset->decodeNs = platform_get_time_ns() - startTime;
+
+  // Failures go to the main thread as well, only it knows about reloads that came in meanwhile
+  if(!decoded)
+  {
+    SM_ERROR("Failed to decode Asset: %s", asset->path);
+    asset->decodeFailed = true;
+  }
+
+  asset->state.store(ASSET_STATE_DECODED, std::memory_order_release);
+  // Every Asset is queued at most once, so this can't run out of space
+  bool pushed = assetLoader.decodedAssets.push((int)(asset - assetLoader.assets));
+  SM_ASSERT(pushed, "Asset upload queue is full");
+}
+
+void queue_asset_decode(Asset* asset)
+{
+  asset->state.store(ASSET_STATE_DECODING, std::memory_order_relaxed);
+  asset->decodeFailed = false;
+  asset->job = {decode_asset_job, asset};
+  run_jobs(&asset->job, 1, &assetLoader.jobCounter);
+}
+
+/*
+* Returns immediately, the Asset is decoded in the background.
+* Requesting the same Asset twice returns the same handle,
+* an unloaded or failed Asset is loaded again
+*/
+AssetHandle request_asset(AssetType type, const char* path, int param = 0)
+{
+  SM_ASSERT(path, "No path supplied!");
+
+  for(int assetIdx = 0; assetIdx < assetLoader.assetCount; assetIdx++)
+  {
+    Asset* asset = &assetLoader.assets[assetIdx];
+    if(asset->type == type && asset->param == param && strcmp(asset->path, path) == 0)
+    {
+      int state = asset->state.load(std::memory_order_acquire);
+      if(state == ASSET_STATE_UNLOADED || state == ASSET_STATE_FAILED)
+      {
+        queue_asset_decode(asset);
+      }
+      return assetIdx;
+    }
+  }
+
+  if(assetLoader.assetCount == MAX_ASSETS || strlen(path) >= MAX_ASSET_PATH_LENGTH)
+  {
+    SM_ERROR("Can't load Asset: %s", path);
+    return INVALID_ASSET_HANDLE;
+  }
+
+  AssetHandle handle = assetLoader.assetCount++;
+  Asset* asset = &assetLoader.assets[handle];
+  asset->type = type;
+  asset->param = param;
+  strcpy(asset->path, path);
+  queue_asset_decode(asset);
+
+  return handle;
+}
+
+/*
+* Decodes the Asset again, e.g. after the file changed. Until the new version
+* is finalized the old one stays in use. Unloaded Assets read the loose file
+* once they are requested again
+*/
+void reload_asset(AssetHandle handle)
+{
+  if(handle < 0 || handle >= assetLoader.assetCount)
+  {
+    return;
+  }
+
+  Asset* asset = &assetLoader.assets[handle];
+  int state = asset->state.load(std::memory_order_acquire);
+  if(state == ASSET_STATE_DECODING || state == ASSET_STATE_DECODED)
+  {
+    asset->reloadPending = true;
+    return;
+  }
+  if(state == ASSET_STATE_UNLOADED)
+  {
+    asset->loose = true;
+    return;
+  }
+
+  asset->loose = true;
+  queue_asset_decode(asset);
+}
+
+AssetState get_asset_state(AssetHandle handle)
+{
+  if(handle < 0 || handle >= assetLoader.assetCount)
+  {
+    return ASSET_STATE_FAILED;
+  }
+
+  return (AssetState)assetLoader.assets[handle].state.load(std::memory_order_acquire);
+}
+
+/*
+* Returns nullptr until the Asset is loaded
+*/
+Asset* get_asset(AssetHandle handle)
+{
+  return get_asset_state(handle) == ASSET_STATE_LOADED? &assetLoader.assets[handle] : nullptr;
+}
+
+/*
+* Releases a loaded Asset, e.g. to free VRAM. The handle stays valid,
+* request_asset() loads it again
+*/
+void unload_asset(AssetHandle handle)
+{
+  if(get_asset_state(handle) != ASSET_STATE_LOADED)
+  {
+    return;
+  }
+
+  Asset* asset = &assetLoader.assets[handle];
+  switch(asset->type)
+  {
+    case ASSET_TYPE_TEXTURE: unload_texture_asset(asset); break;
+    default: SM_ASSERT(false, "Can't unload Asset Type: %d", asset->type); return;
+  }
+
+  SM_TRACE("Unloaded Asset: %s, %.2fMB", asset->path, (double)asset->size / (double)MB(1));
+  asset->textureID = 0;
+  asset->size = 0;
+  asset->state.store(ASSET_STATE_UNLOADED, std::memory_order_release);
+}
+
+void finalize_asset(Asset* asset)
+{
+  long long startTime = platform_get_time_ns();
+
+  bool finalized = false;
+  if(!asset->decodeFailed)
+  {
+    switch(asset->type)
+    {
+      case ASSET_TYPE_TEXTURE: finalized = finalize_texture_asset(asset); break;
+      case ASSET_TYPE_FONT:    finalized = finalize_font_asset(asset);    break;
+      case ASSET_TYPE_SOUND:   finalized = finalize_sound_asset(asset);   break;
+      default: SM_ASSERT(false, "Unknown Asset Type: %d", asset->type);
+    }
+  }
+
+  free(asset->decoded);
+  asset->decoded = nullptr;
+
+  if(finalized)
+  {
+    SM_TRACE("Loaded Asset: %s, decoded in %.2fms, finalized in %.2fms", asset->path,
+             (double)asset->decodeNs / 1000000.0,
+             (double)(platform_get_time_ns() - startTime) / 1000000.0);
+  }
+  else if(!asset->decodeFailed)
+  {
+    SM_ERROR("Failed to finalize Asset: %s", asset->path);
+  }
+  asset->state.store(finalized? ASSET_STATE_LOADED : ASSET_STATE_FAILED,
+                     std::memory_order_release);
+
+  if(asset->reloadPending)
+  {
+    asset->reloadPending = false;
+    asset->loose = true;
+    queue_asset_decode(asset);
+  }
+}
+
+/*
+* Called once per frame on the main thread, finalizes decoded Assets until
+* budgetNs is used up. At least one Asset is finalized, so loading never stalls
+*/
+void update_asset_loader(long long budgetNs = ASSET_UPLOAD_BUDGET_NS)
+{
+  long long startTime = platform_get_time_ns();
+
+  int finalizedCount = 0;
+  int assetIdx;
+  while((!finalizedCount || platform_get_time_ns() - startTime < budgetNs) &&
+        assetLoader.decodedAssets.pop(&assetIdx))
+  {
+    finalize_asset(&assetLoader.assets[assetIdx]);
+    finalizedCount++;
+  }
+
+  // Without other Workers nobody steals the decode Jobs, the main thread runs them
+  while(jobSystem.initialized && jobSystem.workerCount < 2 &&
+        platform_get_time_ns() - startTime < budgetNs)
+  {
+    Job* job = get_job();
+    if(!job)
+    {
+      break;
+    }
+    execute_job(job);
+  }
+}
+
+/*
+* Blocks until the Assets are loaded or failed, the calling
+* thread helps decoding, used when nothing can happen without them
+*/
+void wait_for_assets(AssetHandle* handles, int count)
+{
+  for(int handleIdx = 0; handleIdx < count; handleIdx++)
+  {
+    while(true)
+    {
+      AssetState state = get_asset_state(handles[handleIdx]);
+      if(state == ASSET_STATE_LOADED || state == ASSET_STATE_FAILED)
+      {
+        break;
+      }
+
+      if(state == ASSET_STATE_DECODED)
+      {
+        update_asset_loader(0);
+        continue;
+      }
+
+      Job* job = jobWorkerIdx >= 0 && jobSystem.initialized? get_job() : nullptr;
+      if(job)
+      {
+        execute_job(job);
+      }
+      else
+      {
+        std::this_thread::yield();
+      }
+    }
+  }
+}
+
+/*
+* Waits for the decodes in flight and releases what was never finalized
+*/
+void asset_loader_shutdown()
+{
+  wait_for_counter(&assetLoader.jobCounter);
+
+  for(int assetIdx = 0; assetIdx < assetLoader.assetCount; assetIdx++)
+  {
+    Asset* asset = &assetLoader.assets[assetIdx];
+    if(asset->state.load(std::memory_order_acquire) == ASSET_STATE_DECODED)
+    {
+      free(asset->decoded);
+      asset->decoded = nullptr;
+      close_asset_file(&asset->file);
+    }
+  }
+}
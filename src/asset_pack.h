@@ -0,0 +1,311 @@
+#pragma once
+
+#include "schnitzel_lib.h"
+
+// #############################################################################
+//                           Asset Pack Constants
+// #############################################################################
+// The Cooker packs the runtime Assets into one file, see cooker.cpp. The game
+// maps it once at startup and reads the Assets in place
+constexpr unsigned int ASSET_PACK_MAGIC = 'S' | 'P' << 8 | 'A' << 16 | 'K' << 24;
+// Bump this when the layout changes, old packs are ignored
+constexpr int ASSET_PACK_VERSION = 1;
+// Page aligned, so every entry can be advised on it's own
+constexpr long long ASSET_PACK_ALIGNMENT = KB(4);
+
+const char* ASSET_PACK_PATH = "assets.pak";
+
+enum AssetPackCompression
+{
+  ASSET_PACK_COMPRESSION_NONE,
+  ASSET_PACK_COMPRESSION_LZ4, // Raw LZ4 Blocks, no Frame
+
+  ASSET_PACK_COMPRESSION_COUNT
+};
+
+// #############################################################################
+//                           Asset Pack Structs
+// #############################################################################
+// The table of contents follows the header directly,
+// sorted by pathHash, so lookups are a binary search
+struct AssetPackHeader
+{
+  unsigned int magic;
+  int version;
+  int entryCount;
+  int padding;
+};
+
+struct AssetPackEntry
+{
+  unsigned long long pathHash; // hash_string() of the path the game asks for
+  long long offset;            // From the start of the pack, aligned
+  long long size;              // Once decompressed
+  long long storedSize;        // In the pack
+  int compression;
+  int padding;
+};
+
+struct AssetPack
+{
+  FileView file;
+  AssetPackHeader* header;
+  AssetPackEntry* entries;
+};
+
+/*
+* An Asset read out of the pack or a loose file, close_asset_file() releases it
+*/
+struct AssetFile
+{
+  char* data;
+  long long size;
+
+  // Loose files only
+  FileView looseFile;
+  // Compressed entries are decompressed into malloc'd memory
+  bool decompressed;
+};
+
+// #############################################################################
+//                           Asset Pack Globals
+// #############################################################################
+// Mapped until the game closes, entries are read in place
+static AssetPack assetPack;
+
+// #############################################################################
+//                           Asset Pack Functions
+// #############################################################################
+/*
+* Decompresses a raw LZ4 Block, returns the decompressed
+* size or -1 if the data is broken. Never writes past dstSize
+*/
+long long lz4_decompress(const char* src, long long srcSize, char* dst, long long dstSize)
+{
+  const unsigned char* ip = (const unsigned char*)src;
+  const unsigned char* ipEnd = ip + srcSize;
+  char* op = dst;
+  char* opEnd = dst + dstSize;
+
+  while(ip < ipEnd)
+  {
+    unsigned char token = *ip++;
+
+    long long literalLength = token >> 4;
+    if(literalLength == 15)
+    {
+      unsigned char lengthByte;
+      do
+      {
+        if(ip >= ipEnd)
+        {
+          return -1;
+        }
+        lengthByte = *ip++;
+        literalLength += lengthByte;
+      } while(lengthByte == 255);
+    }
+
+    if(literalLength > ipEnd - ip || literalLength > opEnd - op)
+    {
+      return -1;
+    }
+    memcpy(op, ip, literalLength);
+    op += literalLength;
+    ip += literalLength;
+
+    // The last sequence only has literals
+    if(ip == ipEnd)
+    {
+      break;
+    }
+
+    if(ipEnd - ip < 2)
+    {
+      return -1;
+    }
+    long long offset = ip[0] | ip[1] << 8;
+    ip += 2;
+    if(offset == 0 || offset > op - dst)
+    {
+      return -1;
+    }
+
+    long long matchLength = token & 15;
+    if(matchLength == 15)
+    {
+      unsigned char lengthByte;
+      do
+      {
+        if(ip >= ipEnd)
+        {
+          return -1;
+        }
+        lengthByte = *ip++;
+        matchLength += lengthByte;
+      } while(lengthByte == 255);
+    }
+    matchLength += 4;
+
+    if(matchLength > opEnd - op)
+    {
+      return -1;
+    }
+
+    // Matches can overlap the output, e.g. runs of the same pixel. Everything
+    // from match to op repeats, so the copies double in size
+    char* match = op - offset;
+    while(matchLength > 0)
+    {
+      long long copySize = op - match < matchLength? op - match : matchLength;
+      memcpy(op, match, copySize);
+      op += copySize;
+      matchLength -= copySize;
+    }
+  }
+
+  return op - dst;
+}
+
+void unload_asset_pack()
+{
+  unmap_file(&assetPack.file);
+  assetPack = {};
+}
+
+/*
+* Maps the pack and checks the header, the game falls back to loose files without it
+*/
+bool load_asset_pack(const char* packPath)
+{
+  AssetPack pack = {};
+  pack.file = map_file(packPath, FILE_ACCESS_RANDOM);
+  if(!pack.file.data)
+  {
+    return false;
+  }
+
+  pack.header = (AssetPackHeader*)pack.file.data;
+  pack.entries = (AssetPackEntry*)(pack.header + 1);
+  if(pack.file.size < (long long)sizeof(AssetPackHeader) ||
+     pack.header->magic != ASSET_PACK_MAGIC ||
+     pack.header->version != ASSET_PACK_VERSION ||
+     pack.header->entryCount < 0 ||
+     pack.file.size < (long long)sizeof(AssetPackHeader) +
+                      (long long)sizeof(AssetPackEntry) * pack.header->entryCount)
+  {
+    SM_ERROR("Outdated or broken Asset Pack: %s", packPath);
+    unmap_file(&pack.file);
+    return false;
+  }
+
+  for(int entryIdx = 0; entryIdx < pack.header->entryCount; entryIdx++)
+  {
+    AssetPackEntry* entry = &pack.entries[entryIdx];
+    // Subtracted instead of added, huge offsets and sizes can't overflow
+    if(entry->offset < 0 || entry->offset > pack.file.size ||
+       entry->size < 0 || entry->storedSize < 0 ||
+       entry->storedSize > pack.file.size - entry->offset ||
+       entry->compression < 0 || entry->compression >= ASSET_PACK_COMPRESSION_COUNT ||
+       (entry->compression == ASSET_PACK_COMPRESSION_NONE && entry->size != entry->storedSize))
+    {
+      SM_ERROR("Broken Asset Pack entry %d in %s", entryIdx, packPath);
+      unmap_file(&pack.file);
+      return false;
+    }
+  }
+
+  unload_asset_pack();
+  assetPack = pack;
+  return true;
+}
+
+/*
+* Returns nullptr if the path is not in the pack
+*/
+AssetPackEntry* find_asset_pack_entry(const char* path)
+{
+  if(!assetPack.header)
+  {
+    return nullptr;
+  }
+
+  unsigned long long pathHash = hash_string(path);
+  int low = 0;
+  int high = assetPack.header->entryCount;
+  while(low < high)
+  {
+    int middle = low + (high - low) / 2;
+    if(assetPack.entries[middle].pathHash < pathHash)
+    {
+      low = middle + 1;
+    }
+    else
+    {
+      high = middle;
+    }
+  }
+
+  if(low < assetPack.header->entryCount && assetPack.entries[low].pathHash == pathHash)
+  {
+    return &assetPack.entries[low];
+  }
+  return nullptr;
+}
+
+/*
+* Reads the Asset out of the pack, loose files are used for everything
+* that isn't packed, and always when loose is set, e.g. for Hot Reloading.
+* Thread safe, the pack is only read
+*/
+AssetFile open_asset_file(const char* path, FileAccessHint hint = FILE_ACCESS_NORMAL,
+                          bool loose = false)
+{
+  SM_ASSERT(path, "No path supplied!");
+
+  AssetFile assetFile = {};
+
+  AssetPackEntry* entry = loose? nullptr : find_asset_pack_entry(path);
+  if(!entry)
+  {
+    assetFile.looseFile = map_file(path, hint);
+    assetFile.data = assetFile.looseFile.data;
+    assetFile.size = assetFile.looseFile.size;
+    return assetFile;
+  }
+
+  char* storedData = assetPack.file.data + entry->offset;
+  if(entry->compression == ASSET_PACK_COMPRESSION_NONE)
+  {
+    assetFile.data = storedData;
+    assetFile.size = entry->size;
+    advise_file_view({storedData, entry->storedSize}, hint);
+    return assetFile;
+  }
+
+  // Compressed entries are read front to back once
+  advise_file_view({storedData, entry->storedSize}, FILE_ACCESS_SEQUENTIAL);
+  char* data = (char*)malloc(entry->size);
+  if(!data || lz4_decompress(storedData, entry->storedSize, data, entry->size) != entry->size)
+  {
+    SM_ERROR("Failed to decompress %s from the Asset Pack", path);
+    free(data);
+    return assetFile;
+  }
+
+  assetFile.data = data;
+  assetFile.size = entry->size;
+  assetFile.decompressed = true;
+  return assetFile;
+}
+
+void close_asset_file(AssetFile* assetFile)
+{
+  if(assetFile->decompressed)
+  {
+    free(assetFile->data);
+  }
+  unmap_file(&assetFile->looseFile);
+
+  *assetFile = {};
+}
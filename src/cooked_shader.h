@@ -0,0 +1,20 @@
+#pragma once
+
+#include "schnitzel_lib.h"
+
+// #############################################################################
+//                           Cooked Shader Constants
+// #############################################################################
+// Cooked Shaders are the complete source the driver gets, the version line and
+// shader_header.h are inlined. They are stored next to the Shader,
+// "quad.vert" -> "quad.vert.glsl"
+const char* SHADER_VERSION_LINE = "#version 430 core\r\n";
+const char* SHADER_HEADER_PATH = "src/shader_header.h";
+
+// #############################################################################
+//                           Cooked Shader Functions
+// #############################################################################
+void get_cooked_shader_path(const char* shaderPath, char* cookedPath, int bufferSize)
+{
+  snprintf(cookedPath, bufferSize, "%s.glsl", shaderPath);
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "schnitzel_lib.h"
+
+// The implementation lives in the file that defines STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+// #############################################################################
+//                           Cooked Texture Constants
+// #############################################################################
+// Cooked Textures are stored next to the PNG, "TEXTURE_ATLAS.png" -> "TEXTURE_ATLAS.tex"
+constexpr unsigned int COOKED_TEXTURE_MAGIC = 'S' | 'T' << 8 | 'E' << 16 | 'X' << 24;
+// Bump this when the layout changes, old files get cooked again
+constexpr int COOKED_TEXTURE_VERSION = 1;
+
+enum CookedTextureFormat
+{
+  COOKED_TEXTURE_FORMAT_RGBA8,
+
+  COOKED_TEXTURE_FORMAT_COUNT
+};
+
+// #############################################################################
+//                           Cooked Texture Structs
+// #############################################################################
+// The pixels follow the header directly, ready to be uploaded to the GPU
+struct CookedTextureHeader
+{
+  unsigned int magic;
+  int version;
+  int format;
+  int width;
+  int height;
+  int dataSize;
+  long long sourceTimestamp;
+};
+
+// #############################################################################
+//                           Cooked Texture Functions
+// #############################################################################
+void get_cooked_texture_path(const char* texturePath, char* cookedPath, int bufferSize)
+{
+  const char* extension = strrchr(texturePath, '.');
+  int length = extension? (int)(extension - texturePath) : (int)strlen(texturePath);
+  snprintf(cookedPath, bufferSize, "%.*s.tex", length, texturePath);
+}
+
+/*
+* Returns the header if the file is a cooked texture that
+* is newer than the source file, nullptr otherwise
+*/
+CookedTextureHeader* get_cooked_texture_header(char* file, long long fileSize,
+                                               long long sourceTimestamp)
+{
+  if(!file || fileSize < (long long)sizeof(CookedTextureHeader))
+  {
+    return nullptr;
+  }
+
+  CookedTextureHeader* header = (CookedTextureHeader*)file;
+  if(header->magic != COOKED_TEXTURE_MAGIC ||
+     header->version != COOKED_TEXTURE_VERSION ||
+     header->format != COOKED_TEXTURE_FORMAT_RGBA8 ||
+     header->dataSize != header->width * header->height * 4 ||
+     fileSize < (long long)sizeof(CookedTextureHeader) + header->dataSize ||
+     header->sourceTimestamp != sourceTimestamp)
+  {
+    return nullptr;
+  }
+
+  return header;
+}
+
+/*
+* Decodes the source image once and writes the raw pixels, so
+* loading the Texture is only a copy to the GPU
+*/
+bool cook_texture(const char* texturePath)
+{
+  // Decoded straight out of the mapped PNG
+  FileView pngFile = map_file(texturePath, FILE_ACCESS_SEQUENTIAL);
+  int width, height, channels;
+  unsigned char* data = stbi_load_from_memory((unsigned char*)pngFile.data, (int)pngFile.size,
+                                              &width, &height, &channels, 4);
+  unmap_file(&pngFile);
+  if(!data)
+  {
+    SM_ERROR("Failed to decode Texture: %s", texturePath);
+    return false;
+  }
+
+  CookedTextureHeader header = {};
+  header.magic = COOKED_TEXTURE_MAGIC;
+  header.version = COOKED_TEXTURE_VERSION;
+  header.format = COOKED_TEXTURE_FORMAT_RGBA8;
+  header.width = width;
+  header.height = height;
+  header.dataSize = width * height * 4;
+  header.sourceTimestamp = get_timestamp(texturePath);
+
+  char cookedPath[256] = {};
+  get_cooked_texture_path(texturePath, cookedPath, sizeof(cookedPath));
+
+  bool success = false;
+  auto file = fopen(cookedPath, "wb");
+  if(file)
+  {
+    success = fwrite(&header, sizeof(header), 1, file) == 1 &&
+              fwrite(data, header.dataSize, 1, file) == 1;
+    fclose(file);
+  }
+
+  if(!success)
+  {
+    SM_ERROR("Failed writing cooked Texture: %s", cookedPath);
+  }
+
+  stbi_image_free(data);
+
+  return success;
+}
@@ -0,0 +1,1084 @@
+#include "schnitzel_lib.h"
+
+// To Load PNG Files
+#define STB_IMAGE_IMPLEMENTATION
+#include "cooked_texture.h"
+
+#include "cooked_shader.h"
+#include "asset_pack.h"
+
+// Used for the Timestamps in the Cook Manifest
+#include <time.h>
+#include <chrono>
+
+// #############################################################################
+//                           Cooker Constants
+// #############################################################################
+// The Cooker runs offline, as part of build.sh, and converts the source
+// assets into data the game can use directly.
+constexpr int MAX_SPRITE_NAME_LENGTH = 64;
+
+constexpr unsigned short ASEPRITE_MAGIC = 0xA5E0;
+constexpr unsigned short ASEPRITE_FRAME_MAGIC = 0xF1FA;
+constexpr int ASEPRITE_HEADER_SIZE = 128;
+constexpr int ASEPRITE_FRAME_HEADER_SIZE = 16;
+constexpr int ASEPRITE_CHUNK_HEADER_SIZE = 6;
+constexpr unsigned short ASEPRITE_CHUNK_USER_DATA = 0x2020;
+constexpr unsigned short ASEPRITE_CHUNK_SLICE = 0x2022;
+
+const char* SPRITE_TABLE_PATH = "src/sprite_table.h";
+
+// Remembers what was cooked from which inputs, so only changes are cooked again
+const char* COOK_MANIFEST_PATH = "cooker.manifest";
+// Bump this when a Cook Step changes what it writes, everything is cooked again
+constexpr int COOKER_VERSION = 2;
+constexpr int MAX_COOK_STEPS = 32;
+constexpr int MAX_COOK_FILES = 64;
+constexpr int MAX_COOK_INPUTS = 8;
+constexpr int MAX_COOK_DEPENDENCIES = 16;
+constexpr int MAX_COOK_PATH_LENGTH = 256;
+
+// LZ4 Block format, see https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md
+constexpr int LZ4_MIN_MATCH = 4;
+constexpr int LZ4_MAX_OFFSET = 65535;
+constexpr int LZ4_LAST_LITERALS = 5; // The Block has to end with literals
+constexpr int LZ4_MATCH_LIMIT = 12;  // The last match starts before this
+constexpr int LZ4_HASH_BITS = 16;
+
+// #############################################################################
+//                           Cooker Structs
+// #############################################################################
+struct AtlasSource
+{
+  char* atlasID;
+  char* asepritePath;
+  char* texturePath;
+};
+
+// Sprites are Slices inside of the Aseprite files, named like the SpriteID
+// without the "SPRITE_" prefix. Animations put "frameCount=N" into the
+// User Data of the Slice, the frames are placed next to each other.
+static AtlasSource atlasSources[] =
+{
+  {"ATLAS_MASTER", 
+   "assets/textures/TEXTURE_ATLAS.aseprite", 
+   "assets/textures/TEXTURE_ATLAS.png"},
+  {"ATLAS_ENEMIES", 
+   "assets/textures/TEXTURE_ATLAS_ENEMIES.aseprite", 
+   "assets/textures/TEXTURE_ATLAS_ENEMIES.png"},
+  {"ATLAS_PROJECTILES", 
+   "assets/textures/TEXTURE_ATLAS_PROJECTILES.aseprite", 
+   "assets/textures/TEXTURE_ATLAS_PROJECTILES.png"},
+};
+
+static char* shaderSources[] =
+{
+  "assets/shaders/quad.vert",
+  "assets/shaders/quad.frag",
+};
+
+// Packed under the path the game asks for, the Textures and Shaders are packed cooked
+struct PackSource
+{
+  char* path;
+  AssetPackCompression compression;
+};
+
+static PackSource packSources[] =
+{
+  // Raw pixels, mostly transparent, they shrink a lot
+  {"assets/textures/TEXTURE_ATLAS.tex", ASSET_PACK_COMPRESSION_LZ4},
+  {"assets/textures/TEXTURE_ATLAS_ENEMIES.tex", ASSET_PACK_COMPRESSION_LZ4},
+  {"assets/textures/TEXTURE_ATLAS_PROJECTILES.tex", ASSET_PACK_COMPRESSION_LZ4},
+
+  // Read in place by FreeType and the Audio, so they stay uncompressed
+  {"assets/fonts/AtariClassic-gry3.ttf", ASSET_PACK_COMPRESSION_NONE},
+  {"assets/sounds/died.wav", ASSET_PACK_COMPRESSION_NONE},
+  {"assets/sounds/jump.wav", ASSET_PACK_COMPRESSION_NONE},
+
+  {"assets/shaders/quad.vert.glsl", ASSET_PACK_COMPRESSION_NONE},
+  {"assets/shaders/quad.frag.glsl", ASSET_PACK_COMPRESSION_NONE},
+};
+
+struct SpriteSource
+{
+  char name[MAX_SPRITE_NAME_LENGTH];
+  IVec2 atlasOffset;
+  IVec2 size;
+  int frameCount;
+  int atlasIdx;
+};
+
+enum CookStepType
+{
+  COOK_STEP_SPRITE_TABLE,
+  COOK_STEP_TEXTURE,
+  COOK_STEP_SHADER,
+  COOK_STEP_ASSET_PACK,
+
+  COOK_STEP_COUNT
+};
+
+/*
+* A source file, it's content is only hashed again if the size or the
+* Timestamp changed, or if it changed in the same second it was last cooked
+*/
+struct CookFile
+{
+  char path[MAX_COOK_PATH_LENGTH];
+  long long size;
+  long long timestamp;
+  unsigned long long hash;
+  bool exists;
+};
+
+struct CookStep
+{
+  CookStepType type;
+  char output[MAX_COOK_PATH_LENGTH];
+  int sourceIdx; // Into atlasSources or shaderSources
+
+  // Into Cooker::files
+  int inputCount;
+  int inputs[MAX_COOK_INPUTS];
+  // Earlier Steps that write this Step's inputs
+  int dependencyCount;
+  int dependencies[MAX_COOK_DEPENDENCIES];
+
+  // Hash of everything that goes into the output, cooked again when it changes
+  unsigned long long key;
+  unsigned long long cookedKey; // From the Cook Manifest
+  bool cooked;
+  bool succeeded;
+};
+
+struct Cooker
+{
+  // Files with a Timestamp at or after this may have changed since they were hashed
+  long long manifestTimestamp;
+
+  int fileCount;
+  CookFile files[MAX_COOK_FILES];
+  // What the Cook Manifest recorded, files are matched by path
+  int manifestFileCount;
+  CookFile manifestFiles[MAX_COOK_FILES];
+
+  int stepCount;
+  CookStep steps[MAX_COOK_STEPS];
+};
+
+// #############################################################################
+//                           Cooker Globals
+// #############################################################################
+static Cooker cooker;
+
+// #############################################################################
+//                           Cooker Functions
+// #############################################################################
+unsigned short read_u16(char* data)
+{
+  unsigned short result;
+  memcpy(&result, data, sizeof(result));
+  return result;
+}
+
+unsigned int read_u32(char* data)
+{
+  unsigned int result;
+  memcpy(&result, data, sizeof(result));
+  return result;
+}
+
+/*
+* Aseprite Strings are a WORD length followed by the characters, no zero terminator
+*/
+bool read_sprite_name(char* data, char* name)
+{
+  int length = read_u16(data);
+  if(length >= MAX_SPRITE_NAME_LENGTH)
+  {
+    return false;
+  }
+
+  for(int charIdx = 0; charIdx < length; charIdx++)
+  {
+    char c = data[2 + charIdx];
+    c = (c >= 'a' && c <= 'z')? c - 'a' + 'A' : c;
+
+    bool validChar = (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+    if(!validChar)
+    {
+      return false;
+    }
+    name[charIdx] = c;
+  }
+  name[length] = 0;
+
+  return length > 0;
+}
+
+/*
+* Parses the Slices of an Aseprite file, see
+* https://github.com/aseprite/aseprite/blob/main/docs/ase-file-specs.md
+*/
+bool parse_aseprite_slices(AtlasSource source, int atlasIdx,
+                           DynArray<SpriteSource>* sprites,
+                           BumpAllocator* bumpAllocator)
+{
+  int fileSize = 0;
+  char* file = read_file(source.asepritePath, &fileSize, bumpAllocator);
+  if(!file || fileSize < ASEPRITE_HEADER_SIZE ||
+     read_u16(file + 4) != ASEPRITE_MAGIC)
+  {
+    SM_ERROR("Not an Aseprite file: %s", source.asepritePath);
+    return false;
+  }
+
+  int frameCount = read_u16(file + 6);
+  char* frame = file + ASEPRITE_HEADER_SIZE;
+  for(int frameIdx = 0; frameIdx < frameCount; frameIdx++)
+  {
+    unsigned int frameSize = read_u32(frame);
+    if(read_u16(frame + 4) != ASEPRITE_FRAME_MAGIC ||
+       frame + frameSize > file + fileSize)
+    {
+      SM_ERROR("Corrupt frame %d in: %s", frameIdx, source.asepritePath);
+      return false;
+    }
+
+    // Old files only have the WORD chunk count
+    unsigned int chunkCount = read_u32(frame + 12);
+    if(!chunkCount)
+    {
+      chunkCount = read_u16(frame + 6);
+    }
+
+    SpriteSource* lastSlice = nullptr;
+    char* chunk = frame + ASEPRITE_FRAME_HEADER_SIZE;
+    for(unsigned int chunkIdx = 0; chunkIdx < chunkCount; chunkIdx++)
+    {
+      unsigned int chunkSize = read_u32(chunk);
+      unsigned short chunkType = read_u16(chunk + 4);
+      char* chunkData = chunk + ASEPRITE_CHUNK_HEADER_SIZE;
+
+      if(chunkType == ASEPRITE_CHUNK_SLICE)
+      {
+        SpriteSource sprite = {};
+        sprite.frameCount = 1;
+        sprite.atlasIdx = atlasIdx;
+        if(!read_sprite_name(chunkData + 12, sprite.name))
+        {
+          SM_ERROR("Invalid Slice name in: %s, only A-Z, 0-9 and _ are allowed",
+                   source.asepritePath);
+          return false;
+        }
+
+        // Only the first key is used, Sprites don't move between frames
+        char* sliceKey = chunkData + 12 + 2 + read_u16(chunkData + 12);
+        sprite.atlasOffset = {(int)read_u32(sliceKey + 4), (int)read_u32(sliceKey + 8)};
+        sprite.size = {(int)read_u32(sliceKey + 12), (int)read_u32(sliceKey + 16)};
+
+        for(int spriteIdx = 0; spriteIdx < sprites->count; spriteIdx++)
+        {
+          if(strcmp((*sprites)[spriteIdx].name, sprite.name) == 0)
+          {
+            SM_ERROR("Duplicate Sprite: %s in: %s", sprite.name, source.asepritePath);
+            return false;
+          }
+        }
+
+        lastSlice = &(*sprites)[sprites->add(sprite)];
+      }
+      else if(chunkType == ASEPRITE_CHUNK_USER_DATA && lastSlice)
+      {
+        // User Data belongs to the chunk before it, flag 1 means it has text
+        if(read_u32(chunkData) & 1)
+        {
+          char text[256] = {};
+          int length = min((int)read_u16(chunkData + 4), (int)sizeof(text) - 1);
+          memcpy(text, chunkData + 6, length);
+          sscanf(text, "frameCount=%d", &lastSlice->frameCount);
+        }
+        lastSlice = nullptr;
+      }
+      else
+      {
+        lastSlice = nullptr;
+      }
+
+      chunk += chunkSize;
+    }
+
+    frame += frameSize;
+  }
+
+  return true;
+}
+
+/*
+* Writes the Sprite Table header, only touches the file if the
+* contents changed, so the game doesn't rebuild for nothing
+*/
+bool write_sprite_table(DynArray<SpriteSource>* sprites, BumpAllocator* bumpAllocator)
+{
+  int capacity = KB(64) + sprites->count * 256;
+  char* text = bump_alloc(bumpAllocator, capacity);
+  int length = 0;
+
+  auto append = [&](const char* format, auto... args)
+  {
+    length += snprintf(text + length, capacity - length, format, args...);
+  };
+
+  append("#pragma once\n\n");
+  append("// #############################################################################\n");
+  append("//                 Generated by src/cooker.cpp, DO NOT EDIT!\n");
+  append("// #############################################################################\n");
+  append("// Sprites are Slices inside of the Aseprite files in assets/textures\n\n");
+
+  append("enum AtlasID\n{\n");
+  for(int atlasIdx = 0; atlasIdx < ArraySize(atlasSources); atlasIdx++)
+  {
+    append("  %s,\n", atlasSources[atlasIdx].atlasID);
+  }
+  append("\n  ATLAS_COUNT\n};\n\n");
+
+  append("// The Renderer loads an Atlas the first time one of it's Sprites is drawn\n");
+  append("constexpr const char* ATLAS_TEXTURE_PATHS[ATLAS_COUNT] =\n{\n");
+  for(int atlasIdx = 0; atlasIdx < ArraySize(atlasSources); atlasIdx++)
+  {
+    append("  \"%s\", // %s\n", atlasSources[atlasIdx].texturePath, atlasSources[atlasIdx].atlasID);
+  }
+  append("};\n\n");
+
+  append("enum SpriteID\n{\n");
+  for(int spriteIdx = 0; spriteIdx < sprites->count; spriteIdx++)
+  {
+    append("  SPRITE_%s,\n", (*sprites)[spriteIdx].name);
+  }
+  append("\n  SPRITE_COUNT\n};\n\n");
+
+  append("constexpr Sprite SPRITE_TABLE[SPRITE_COUNT] =\n{\n");
+  for(int spriteIdx = 0; spriteIdx < sprites->count; spriteIdx++)
+  {
+    SpriteSource& sprite = (*sprites)[spriteIdx];
+    append("  {{%d, %d}, {%d, %d}, %d, %s}, // SPRITE_%s\n",
+           sprite.atlasOffset.x, sprite.atlasOffset.y, sprite.size.x, sprite.size.y,
+           sprite.frameCount, atlasSources[sprite.atlasIdx].atlasID, sprite.name);
+  }
+  append("};\n");
+
+  if(length >= capacity)
+  {
+    SM_ERROR("Sprite Table doesn't fit into the buffer");
+    return false;
+  }
+
+  if(file_exists(SPRITE_TABLE_PATH))
+  {
+    int oldLength = 0;
+    char* oldText = read_file(SPRITE_TABLE_PATH, &oldLength, bumpAllocator);
+    if(oldText && oldLength == length && memcmp(oldText, text, length) == 0)
+    {
+      return true;
+    }
+  }
+
+  write_file(SPRITE_TABLE_PATH, text, length);
+  SM_TRACE("Cooked %s, %d Sprites", SPRITE_TABLE_PATH, sprites->count);
+
+  return true;
+}
+
+/*
+* Only the header is needed to know if the cooked Texture is intact. The content
+* hash in the cook key already says if it belongs to the PNG, the timestamp in the
+* header is left to the runtime fallback, touching the PNG doesn't cook it again
+*/
+bool is_cooked_texture_current(const char* texturePath)
+{
+  char cookedPath[256] = {};
+  get_cooked_texture_path(texturePath, cookedPath, sizeof(cookedPath));
+
+  CookedTextureHeader header = {};
+  auto file = fopen(cookedPath, "rb");
+  if(!file)
+  {
+    return false;
+  }
+
+  bool readHeader = fread(&header, sizeof(header), 1, file) == 1;
+  fseek(file, 0, SEEK_END);
+  long fileSize = ftell(file);
+  fclose(file);
+
+  return readHeader && get_cooked_texture_header((char*)&header, fileSize, 
+                                                 header.sourceTimestamp);
+}
+
+/*
+* Inlines the version line and shader_header.h, the game hands the result to the driver as is
+*/
+bool cook_shader(const char* shaderPath, BumpAllocator* bumpAllocator)
+{
+  int headerSize = 0;
+  int sourceSize = 0;
+  char* header = read_file(SHADER_HEADER_PATH, &headerSize, bumpAllocator);
+  char* source = read_file(shaderPath, &sourceSize, bumpAllocator);
+  if(!header || !source)
+  {
+    return false;
+  }
+
+  char cookedPath[256] = {};
+  get_cooked_shader_path(shaderPath, cookedPath, sizeof(cookedPath));
+
+  bool success = false;
+  auto file = fopen(cookedPath, "wb");
+  if(file)
+  {
+    success = fputs(SHADER_VERSION_LINE, file) >= 0 &&
+              fwrite(header, headerSize, 1, file) == 1 &&
+              fwrite(source, sourceSize, 1, file) == 1;
+    fclose(file);
+  }
+
+  if(!success)
+  {
+    SM_ERROR("Failed writing cooked Shader: %s", cookedPath);
+  }
+
+  return success;
+}
+
+/*
+* Worst case size of lz4_compress(), when nothing matches
+*/
+long long lz4_compress_bound(long long size)
+{
+  return size + size / 255 + 16;
+}
+
+/*
+* Writes a length that doesn't fit into the token, 255 means another byte follows
+*/
+char* lz4_write_length(char* op, long long length)
+{
+  for(; length >= 255; length -= 255)
+  {
+    *op++ = (char)255;
+  }
+  *op++ = (char)length;
+  return op;
+}
+
+char* lz4_write_sequence(char* op, const char* literals, long long literalLength,
+                         long long offset, long long matchLength)
+{
+  char* token = op++;
+  *token = (char)((literalLength < 15? literalLength : 15) << 4);
+  if(literalLength >= 15)
+  {
+    op = lz4_write_length(op, literalLength - 15);
+  }
+  memcpy(op, literals, literalLength);
+  op += literalLength;
+
+  // The last sequence only has literals
+  if(!matchLength)
+  {
+    return op;
+  }
+
+  *op++ = (char)(offset & 0xFF);
+  *op++ = (char)(offset >> 8);
+
+  matchLength -= LZ4_MIN_MATCH;
+  *token |= (char)(matchLength < 15? matchLength : 15);
+  if(matchLength >= 15)
+  {
+    op = lz4_write_length(op, matchLength - 15);
+  }
+
+  return op;
+}
+
+/*
+* Greedy LZ4 Block compressor, fast enough for the Cooker, the game only
+* decompresses, see lz4_decompress(). dst needs lz4_compress_bound() bytes
+*/
+long long lz4_compress(const char* src, long long srcSize, char* dst, BumpAllocator* bumpAllocator)
+{
+  TempArena temp = begin_temp(bumpAllocator);
+  // Last position of every hashed 4 byte sequence, -1 for none
+  long long* hashTable = 
+    (long long*)bump_alloc(bumpAllocator, sizeof(long long) << LZ4_HASH_BITS);
+  memset(hashTable, 0xFF, sizeof(long long) << LZ4_HASH_BITS);
+
+  char* op = dst;
+  long long anchor = 0;
+  long long srcIdx = 0;
+  while(srcIdx + LZ4_MATCH_LIMIT < srcSize)
+  {
+    unsigned int sequence = read_u32((char*)src + srcIdx);
+    unsigned int hash = (sequence * 2654435761u) >> (32 - LZ4_HASH_BITS);
+    long long matchIdx = hashTable[hash];
+    hashTable[hash] = srcIdx;
+
+    if(matchIdx < 0 || srcIdx - matchIdx > LZ4_MAX_OFFSET ||
+       read_u32((char*)src + matchIdx) != sequence)
+    {
+      srcIdx++;
+      continue;
+    }
+
+    long long matchLength = LZ4_MIN_MATCH;
+    long long matchEnd = srcSize - LZ4_LAST_LITERALS;
+    while(srcIdx + matchLength < matchEnd && src[matchIdx + matchLength] == src[srcIdx + matchLength])
+    {
+      matchLength++;
+    }
+
+    op = lz4_write_sequence(op, src + anchor, srcIdx - anchor, srcIdx - matchIdx, matchLength);
+    srcIdx += matchLength;
+    anchor = srcIdx;
+  }
+
+  op = lz4_write_sequence(op, src + anchor, srcSize - anchor, 0, 0);
+  end_temp(temp);
+
+  return op - dst;
+}
+
+/*
+* Packs every PackSource into one file, the game maps it at startup, see asset_pack.h
+*/
+bool write_asset_pack(const char* packPath, BumpAllocator* bumpAllocator)
+{
+  constexpr int entryCount = ArraySize(packSources);
+  AssetPackEntry entries[entryCount] = {};
+
+  // Written next to the pack and moved over it at the end, the running game keeps the old one
+  char tempPath[256] = {};
+  snprintf(tempPath, sizeof(tempPath), "%s.tmp", packPath);
+  auto file = fopen(tempPath, "wb");
+  if(!file)
+  {
+    SM_ERROR("Failed opening File: %s", tempPath);
+    return false;
+  }
+
+  auto align = [](long long offset)
+  {
+    return (offset + ASSET_PACK_ALIGNMENT - 1) & ~(ASSET_PACK_ALIGNMENT - 1);
+  };
+
+  bool success = true;
+  long long packedSize = 0;
+  long long offset = align(sizeof(AssetPackHeader) + sizeof(entries));
+  for(int sourceIdx = 0; sourceIdx < entryCount && success; sourceIdx++)
+  {
+    PackSource source = packSources[sourceIdx];
+    TempArena temp = begin_temp(bumpAllocator);
+
+    int fileSize = 0;
+    char* data = read_file(source.path, &fileSize, bumpAllocator);
+    if(!data)
+    {
+      success = false;
+      break;
+    }
+
+    AssetPackEntry* entry = &entries[sourceIdx];
+    entry->pathHash = hash_string(source.path);
+    entry->offset = offset;
+    entry->size = fileSize;
+    entry->storedSize = fileSize;
+    entry->compression = ASSET_PACK_COMPRESSION_NONE;
+
+    char* storedData = data;
+    if(source.compression == ASSET_PACK_COMPRESSION_LZ4)
+    {
+      char* compressed = bump_alloc(bumpAllocator, lz4_compress_bound(fileSize));
+      long long compressedSize = lz4_compress(data, fileSize, compressed, bumpAllocator);
+
+      // Only kept if it pays off
+      if(compressedSize < fileSize)
+      {
+        storedData = compressed;
+        entry->storedSize = compressedSize;
+        entry->compression = ASSET_PACK_COMPRESSION_LZ4;
+      }
+    }
+
+    for(int otherIdx = 0; otherIdx < sourceIdx; otherIdx++)
+    {
+      if(entries[otherIdx].pathHash == entry->pathHash)
+      {
+        SM_ERROR("Path hash collision: %s, %s", packSources[otherIdx].path, source.path);
+        success = false;
+      }
+    }
+
+    success = success &&
+              fseek(file, (long)offset, SEEK_SET) == 0 &&
+              fwrite(storedData, 1, entry->storedSize, file) == (size_t)entry->storedSize;
+    offset = align(offset + entry->storedSize);
+    packedSize += entry->storedSize;
+
+    end_temp(temp);
+  }
+
+  // The table of contents is sorted, the game does a binary search
+  qsort(entries, entryCount, sizeof(AssetPackEntry), [](const void* a, const void* b)
+  {
+    unsigned long long hashA = ((AssetPackEntry*)a)->pathHash;
+    unsigned long long hashB = ((AssetPackEntry*)b)->pathHash;
+    return hashA < hashB? -1 : hashA > hashB? 1 : 0;
+  });
+
+  AssetPackHeader header = {};
+  header.magic = ASSET_PACK_MAGIC;
+  header.version = ASSET_PACK_VERSION;
+  header.entryCount = entryCount;
+  success = success &&
+            fseek(file, 0, SEEK_SET) == 0 &&
+            fwrite(&header, sizeof(header), 1, file) == 1 &&
+            fwrite(entries, sizeof(entries), 1, file) == 1;
+  fclose(file);
+
+  // Windows can't rename over an existing file
+  if(!success || (remove(packPath), rename(tempPath, packPath) != 0))
+  {
+    SM_ERROR("Failed writing Asset Pack: %s", packPath);
+    remove(tempPath);
+    return false;
+  }
+  SM_TRACE("Cooked %s, %d Assets, %.2fMB", packPath, entryCount, (double)packedSize / MB(1));
+
+  return true;
+}
+
+// The Cooker doesn't link the platform layer
+long long get_cook_time_ns()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/*
+* Returns the index into Cooker::files, every file is only hashed once
+*/
+int add_cook_file(const char* path)
+{
+  for(int fileIdx = 0; fileIdx < cooker.fileCount; fileIdx++)
+  {
+    if(strcmp(cooker.files[fileIdx].path, path) == 0)
+    {
+      return fileIdx;
+    }
+  }
+
+  SM_ASSERT(cooker.fileCount < MAX_COOK_FILES, "Too many Cook Files");
+  SM_ASSERT(strlen(path) < MAX_COOK_PATH_LENGTH, "Cook File path too long: %s", path);
+  CookFile* file = &cooker.files[cooker.fileCount];
+  strcpy(file->path, path);
+  return cooker.fileCount++;
+}
+
+CookStep* add_cook_step(CookStepType type, const char* output, int sourceIdx = 0)
+{
+  SM_ASSERT(cooker.stepCount < MAX_COOK_STEPS, "Too many Cook Steps");
+  CookStep* step = &cooker.steps[cooker.stepCount++];
+  step->type = type;
+  step->sourceIdx = sourceIdx;
+  snprintf(step->output, MAX_COOK_PATH_LENGTH, "%s", output);
+  return step;
+}
+
+void add_cook_input(CookStep* step, const char* path)
+{
+  SM_ASSERT(step->inputCount < MAX_COOK_INPUTS, "Too many inputs for: %s", step->output);
+  step->inputs[step->inputCount++] = add_cook_file(path);
+}
+
+/*
+* Inputs that an earlier Step writes become a dependency on that Step
+*/
+void add_cook_input_or_dependency(CookStep* step, const char* path)
+{
+  for(int stepIdx = 0; stepIdx < cooker.stepCount; stepIdx++)
+  {
+    if(&cooker.steps[stepIdx] != step && strcmp(cooker.steps[stepIdx].output, path) == 0)
+    {
+      SM_ASSERT(step->dependencyCount < MAX_COOK_DEPENDENCIES, 
+                "Too many dependencies for: %s", step->output);
+      step->dependencies[step->dependencyCount++] = stepIdx;
+      return;
+    }
+  }
+
+  add_cook_input(step, path);
+}
+
+/*
+* Every output and the files it is cooked from, shader_header.h feeds both Shaders
+* and the Asset Pack depends on the Steps that cook what it packs
+*/
+void add_cook_steps()
+{
+  CookStep* spriteTable = add_cook_step(COOK_STEP_SPRITE_TABLE, SPRITE_TABLE_PATH);
+  for(int atlasIdx = 0; atlasIdx < ArraySize(atlasSources); atlasIdx++)
+  {
+    add_cook_input(spriteTable, atlasSources[atlasIdx].asepritePath);
+  }
+
+  for(int atlasIdx = 0; atlasIdx < ArraySize(atlasSources); atlasIdx++)
+  {
+    char cookedPath[MAX_COOK_PATH_LENGTH] = {};
+    get_cooked_texture_path(atlasSources[atlasIdx].texturePath, cookedPath, sizeof(cookedPath));
+    CookStep* texture = add_cook_step(COOK_STEP_TEXTURE, cookedPath, atlasIdx);
+    add_cook_input(texture, atlasSources[atlasIdx].texturePath);
+  }
+
+  for(int shaderIdx = 0; shaderIdx < ArraySize(shaderSources); shaderIdx++)
+  {
+    char cookedPath[MAX_COOK_PATH_LENGTH] = {};
+    get_cooked_shader_path(shaderSources[shaderIdx], cookedPath, sizeof(cookedPath));
+    CookStep* shader = add_cook_step(COOK_STEP_SHADER, cookedPath, shaderIdx);
+    add_cook_input(shader, SHADER_HEADER_PATH);
+    add_cook_input(shader, shaderSources[shaderIdx]);
+  }
+
+  CookStep* assetPack = add_cook_step(COOK_STEP_ASSET_PACK, ASSET_PACK_PATH);
+  for(int sourceIdx = 0; sourceIdx < ArraySize(packSources); sourceIdx++)
+  {
+    add_cook_input_or_dependency(assetPack, packSources[sourceIdx].path);
+  }
+}
+
+/*
+* Lines are "file <size> <timestamp> <hash> <path>" and "step <key> <output>",
+* a missing or broken Manifest cooks everything
+*/
+void load_cook_manifest(BumpAllocator* bumpAllocator)
+{
+  int fileSize = 0;
+  char* text = file_exists(COOK_MANIFEST_PATH)? 
+               read_file(COOK_MANIFEST_PATH, &fileSize, bumpAllocator) : nullptr;
+  if(!text)
+  {
+    return;
+  }
+
+  char* line = text;
+  while(line && *line)
+  {
+    char* lineEnd = strchr(line, '\n');
+    if(lineEnd)
+    {
+      *lineEnd = 0;
+    }
+
+    CookFile file = {};
+    unsigned long long key = 0;
+    char output[MAX_COOK_PATH_LENGTH] = {};
+    if(sscanf(line, "version %lld", &cooker.manifestTimestamp) == 1)
+    {
+      // Written first, a different Cooker ignores the rest
+      int version = 0;
+      if(sscanf(line, "version %*lld %d", &version) != 1 || version != COOKER_VERSION)
+      {
+        cooker.manifestTimestamp = 0;
+        return;
+      }
+    }
+    else if(sscanf(line, "file %lld %lld %llx %255[^\n]", &file.size, &file.timestamp,
+                   &file.hash, file.path) == 4 &&
+            cooker.manifestFileCount < MAX_COOK_FILES)
+    {
+      file.exists = true;
+      cooker.manifestFiles[cooker.manifestFileCount++] = file;
+    }
+    else if(sscanf(line, "step %llx %255[^\n]", &key, output) == 2)
+    {
+      for(int stepIdx = 0; stepIdx < cooker.stepCount; stepIdx++)
+      {
+        if(strcmp(cooker.steps[stepIdx].output, output) == 0)
+        {
+          cooker.steps[stepIdx].cookedKey = key;
+        }
+      }
+    }
+
+    line = lineEnd? lineEnd + 1 : nullptr;
+  }
+}
+
+/*
+* Only cooked Steps are written, a failed Step is cooked again next time
+*/
+void save_cook_manifest(long long cookTimestamp)
+{
+  auto file = fopen(COOK_MANIFEST_PATH, "wb");
+  if(!file)
+  {
+    SM_ERROR("Failed opening File: %s", COOK_MANIFEST_PATH);
+    return;
+  }
+
+  fprintf(file, "version %lld %d\n", cookTimestamp, COOKER_VERSION);
+  for(int fileIdx = 0; fileIdx < cooker.fileCount; fileIdx++)
+  {
+    CookFile* cookFile = &cooker.files[fileIdx];
+    if(cookFile->exists)
+    {
+      fprintf(file, "file %lld %lld %llx %s\n", cookFile->size, cookFile->timestamp,
+              cookFile->hash, cookFile->path);
+    }
+  }
+  for(int stepIdx = 0; stepIdx < cooker.stepCount; stepIdx++)
+  {
+    CookStep* step = &cooker.steps[stepIdx];
+    if(step->succeeded)
+    {
+      fprintf(file, "step %llx %s\n", step->key, step->output);
+    }
+  }
+
+  fclose(file);
+}
+
+void hash_cook_files(void* data, int start, int end)
+{
+  for(int fileIdx = start; fileIdx < end; fileIdx++)
+  {
+    CookFile* file = &cooker.files[fileIdx];
+
+    struct stat fileStat = {};
+    file->exists = stat(file->path, &fileStat) == 0;
+    if(!file->exists)
+    {
+      continue;
+    }
+    file->size = fileStat.st_size;
+    file->timestamp = fileStat.st_mtime;
+
+    // Unchanged files keep their hash, without reading them
+    for(int recordIdx = 0; recordIdx < cooker.manifestFileCount; recordIdx++)
+    {
+      CookFile* record = &cooker.manifestFiles[recordIdx];
+      if(strcmp(record->path, file->path) == 0 &&
+         record->size == file->size &&
+         record->timestamp == file->timestamp &&
+         record->timestamp < cooker.manifestTimestamp)
+      {
+        file->hash = record->hash;
+        break;
+      }
+    }
+
+    if(!file->hash)
+    {
+      FileView view = map_file(file->path, FILE_ACCESS_SEQUENTIAL);
+      // 0 is reserved for not hashed
+      file->hash = hash_data(view.data, view.size) | 1;
+      unmap_file(&view);
+    }
+  }
+}
+
+/*
+* Steps only depend on earlier Steps, so one pass computes every key
+*/
+bool compute_cook_keys()
+{
+  bool allInputsExist = true;
+  for(int stepIdx = 0; stepIdx < cooker.stepCount; stepIdx++)
+  {
+    CookStep* step = &cooker.steps[stepIdx];
+
+    int versions[] = {COOKER_VERSION, step->type, COOKED_TEXTURE_VERSION, ASSET_PACK_VERSION};
+    unsigned long long key = hash_data(versions, sizeof(versions));
+    for(int inputIdx = 0; inputIdx < step->inputCount; inputIdx++)
+    {
+      CookFile* file = &cooker.files[step->inputs[inputIdx]];
+      if(!file->exists)
+      {
+        SM_ERROR("Missing input: %s for %s", file->path, step->output);
+        allInputsExist = false;
+      }
+      key = hash_data(&file->hash, sizeof(file->hash), key);
+    }
+    for(int dependencyIdx = 0; dependencyIdx < step->dependencyCount; dependencyIdx++)
+    {
+      key = hash_data(&cooker.steps[step->dependencies[dependencyIdx]].key, sizeof(key), key);
+    }
+
+    step->key = key;
+  }
+
+  return allInputsExist;
+}
+
+bool is_cook_output_current(CookStep* step)
+{
+  if(step->key != step->cookedKey)
+  {
+    return false;
+  }
+
+  // Somebody could have deleted or replaced it
+  if(step->type == COOK_STEP_TEXTURE)
+  {
+    return is_cooked_texture_current(atlasSources[step->sourceIdx].texturePath);
+  }
+  return file_exists(step->output);
+}
+
+bool run_cook_step(CookStep* step)
+{
+  TempArenaScope scratch(get_scratch());
+
+  switch(step->type)
+  {
+    case COOK_STEP_SPRITE_TABLE:
+    {
+      // Lives in it's own Arena, so it can always grow in place, runs once per Cooker run
+      static BumpAllocator spriteAllocator = make_bump_allocator(MB(1), "Sprites");
+      DynArray<SpriteSource> sprites = make_dyn_array<SpriteSource>(&spriteAllocator);
+
+      bool success = true;
+      for(int atlasIdx = 0; atlasIdx < ArraySize(atlasSources) && success; atlasIdx++)
+      {
+        success = parse_aseprite_slices(atlasSources[atlasIdx], atlasIdx, 
+                                        &sprites, scratch.arena());
+      }
+      success = success && write_sprite_table(&sprites, scratch.arena());
+
+      return success;
+    }
+
+    case COOK_STEP_TEXTURE:
+    {
+      return cook_texture(atlasSources[step->sourceIdx].texturePath);
+    }
+
+    case COOK_STEP_SHADER:
+    {
+      return cook_shader(shaderSources[step->sourceIdx], scratch.arena());
+    }
+
+    case COOK_STEP_ASSET_PACK:
+    {
+      return write_asset_pack(step->output, scratch.arena());
+    }
+
+    default:
+    {
+      SM_ASSERT(false, "Unknown Cook Step: %d", step->type);
+      return false;
+    }
+  }
+}
+
+/*
+* Runs the Steps of one pass, a Step that depends on a failed Step fails as well
+*/
+void cook_steps_job(void* data, int start, int end)
+{
+  int* stepIdxs = (int*)data;
+  for(int idx = start; idx < end; idx++)
+  {
+    CookStep* step = &cooker.steps[stepIdxs[idx]];
+
+    step->succeeded = true;
+    for(int dependencyIdx = 0; dependencyIdx < step->dependencyCount; dependencyIdx++)
+    {
+      step->succeeded = step->succeeded && cooker.steps[step->dependencies[dependencyIdx]].succeeded;
+    }
+
+    if(step->succeeded && !is_cook_output_current(step))
+    {
+      long long startTime = get_cook_time_ns();
+      step->succeeded = run_cook_step(step);
+      step->cooked = true;
+      if(step->succeeded)
+      {
+        SM_TRACE("Cooked %s in %.2fms", step->output,
+                 (double)(get_cook_time_ns() - startTime) / 1000000.0);
+      }
+    }
+
+    if(!step->succeeded)
+    {
+      SM_ERROR("Failed cooking: %s", step->output);
+    }
+  }
+}
+
+int main()
+{
+  long long startTime = get_cook_time_ns();
+  long long cookTimestamp = time(nullptr);
+
+  job_system_init();
+
+  add_cook_steps();
+  {
+    TempArenaScope scratch(get_scratch());
+    load_cook_manifest(scratch.arena());
+  }
+
+  parallel_for(cooker.fileCount, 1, hash_cook_files, nullptr);
+  if(!compute_cook_keys())
+  {
+    job_system_shutdown();
+    return -1;
+  }
+
+  // Steps without dependencies run in the first pass, the rest once their dependencies are done
+  bool done[MAX_COOK_STEPS] = {};
+  int doneCount = 0;
+  while(doneCount < cooker.stepCount)
+  {
+    int passSteps[MAX_COOK_STEPS];
+    int passStepCount = 0;
+    for(int stepIdx = 0; stepIdx < cooker.stepCount; stepIdx++)
+    {
+      CookStep* step = &cooker.steps[stepIdx];
+      bool ready = !done[stepIdx];
+      for(int dependencyIdx = 0; dependencyIdx < step->dependencyCount; dependencyIdx++)
+      {
+        ready = ready && done[step->dependencies[dependencyIdx]];
+      }
+
+      if(ready)
+      {
+        passSteps[passStepCount++] = stepIdx;
+      }
+    }
+
+    parallel_for(passStepCount, 1, cook_steps_job, passSteps);
+    for(int passIdx = 0; passIdx < passStepCount; passIdx++)
+    {
+      done[passSteps[passIdx]] = true;
+    }
+    doneCount += passStepCount;
+  }
+
+  save_cook_manifest(cookTimestamp);
+  job_system_shutdown();
+
+  int cookedCount = 0;
+  bool success = true;
+  for(int stepIdx = 0; stepIdx < cooker.stepCount; stepIdx++)
+  {
+    cookedCount += cooker.steps[stepIdx].cooked;
+    success = success && cooker.steps[stepIdx].succeeded;
+  }
+  SM_TRACE("Cooked %d of %d outputs in %.2fms", cookedCount, cooker.stepCount,
+           (double)(get_cook_time_ns() - startTime) / 1000000.0);
+
+  return success? 0 : -1;
+}
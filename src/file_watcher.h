@@ -0,0 +1,180 @@
+#pragma once
+
+#include "schnitzel_lib.h"
+#include "platform.h"
+
+// #############################################################################
+//                           File Watcher Constants
+// #############################################################################
+constexpr int MAX_WATCHED_FILES = 32;
+constexpr int MAX_WATCH_PATH_LENGTH = 256;
+// Has to be a power of 2
+constexpr int FILE_WATCH_EVENT_CAPACITY = 64;
+
+// Editors and compilers write files in several steps, a file has to be
+// quiet for this long before the change is reported
+constexpr long long FILE_WATCH_DEBOUNCE_NS = 100000000;
+
+// #############################################################################
+//                           File Watcher Structs
+// #############################################################################
+struct WatchedFile
+{
+  char path[MAX_WATCH_PATH_LENGTH];
+  char directory[MAX_WATCH_PATH_LENGTH]; // "." for files in the working directory
+  char* fileName; // Points into path
+
+  // Whatever the platform uses to identify the watched directory
+  long long platformWatchID;
+
+  // Watcher thread only, 0 means no change is waiting for the debounce
+  long long lastChangeNs;
+  long long lastTimestamp;
+
+  // Main thread only, set from the events, cleared by file_changed()
+  bool changed;
+};
+
+/*
+* The platform watches the directories on a background thread, the file
+* changes are debounced there and queued for the main thread. Checking for
+* changes is only a look into the queue, no syscall
+*/
+struct FileWatcher
+{
+  // Files are only added on the main thread, the count publishes them
+  std::atomic<int> watchCount;
+  WatchedFile files[MAX_WATCHED_FILES];
+
+  // Debounced changes, watcher thread -> main thread
+  SPSCRing<int, FILE_WATCH_EVENT_CAPACITY> events;
+};
+
+// #############################################################################
+//                           File Watcher Globals
+// #############################################################################
+static FileWatcher fileWatcher;
+
+// #############################################################################
+//                           File Watcher Functions
+// #############################################################################
+/*
+* Returns the watchIdx used with file_changed(), -1 if the file can't be watched.
+* Watching the same file twice returns the same watchIdx
+*/
+int watch_file(const char* filePath)
+{
+  SM_ASSERT(filePath, "No filePath supplied!");
+
+  int watchCount = fileWatcher.watchCount.load(std::memory_order_relaxed);
+  for(int watchIdx = 0; watchIdx < watchCount; watchIdx++)
+  {
+    if(strcmp(fileWatcher.files[watchIdx].path, filePath) == 0)
+    {
+      return watchIdx;
+    }
+  }
+
+  if(watchCount == MAX_WATCHED_FILES || strlen(filePath) >= MAX_WATCH_PATH_LENGTH)
+  {
+    SM_ERROR("Can't watch File: %s", filePath);
+    return -1;
+  }
+
+  WatchedFile* watchedFile = &fileWatcher.files[watchCount];
+  *watchedFile = {};
+  strcpy(watchedFile->path, filePath);
+  watchedFile->lastTimestamp = get_timestamp(filePath);
+
+  // Directories are watched, editors often replace the file instead of writing it
+  char* lastSlash = strrchr(watchedFile->path, '/');
+  if(lastSlash)
+  {
+    snprintf(watchedFile->directory, MAX_WATCH_PATH_LENGTH, "%.*s",
+             (int)(lastSlash - watchedFile->path), watchedFile->path);
+    watchedFile->fileName = lastSlash + 1;
+  }
+  else
+  {
+    strcpy(watchedFile->directory, ".");
+    watchedFile->fileName = watchedFile->path;
+  }
+
+  if(!platform_watch_directory(watchedFile))
+  {
+    SM_ERROR("Failed to watch Directory: %s", watchedFile->directory);
+    return -1;
+  }
+
+  // The watcher thread sees the file from here on
+  fileWatcher.watchCount.store(watchCount + 1, std::memory_order_release);
+  platform_wake_file_watcher();
+
+  return watchCount;
+}
+
+/*
+* Returns true once per change of the file
+*/
+bool file_changed(int watchIdx)
+{
+  int changedIdx;
+  while(fileWatcher.events.pop(&changedIdx))
+  {
+    fileWatcher.files[changedIdx].changed = true;
+  }
+
+  if(watchIdx < 0)
+  {
+    return false;
+  }
+
+  bool changed = fileWatcher.files[watchIdx].changed;
+  fileWatcher.files[watchIdx].changed = false;
+  return changed;
+}
+
+/*
+* Called by the watcher thread for every change the OS reports
+*/
+void file_watcher_touch(int watchIdx, long long timeNs)
+{
+  fileWatcher.files[watchIdx].lastChangeNs = timeNs;
+}
+
+/*
+* Called by the watcher thread, queues the files that have been quiet long enough.
+* Returns the milliseconds until the next file is due, -1 if none is waiting
+*/
+int file_watcher_publish(long long timeNs)
+{
+  long long nextDueNs = -1;
+
+  int watchCount = fileWatcher.watchCount.load(std::memory_order_acquire);
+  for(int watchIdx = 0; watchIdx < watchCount; watchIdx++)
+  {
+    WatchedFile* watchedFile = &fileWatcher.files[watchIdx];
+    if(!watchedFile->lastChangeNs)
+    {
+      continue;
+    }
+
+    long long dueNs = watchedFile->lastChangeNs + FILE_WATCH_DEBOUNCE_NS;
+    if(dueNs <= timeNs && fileWatcher.events.push(watchIdx))
+    {
+      watchedFile->lastChangeNs = 0;
+      continue;
+    }
+
+    // Still changing, or the main thread didn't catch up, try again later
+    dueNs = dueNs > timeNs? dueNs : timeNs + FILE_WATCH_DEBOUNCE_NS;
+    nextDueNs = nextDueNs < 0 || dueNs < nextDueNs? dueNs : nextDueNs;
+  }
+
+  if(nextDueNs < 0)
+  {
+    return -1;
+  }
+
+  return (int)((nextDueNs - timeNs + 999999) / 1000000);
+}
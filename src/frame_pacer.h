@@ -0,0 +1,208 @@
+#pragma once
+
+#include "schnitzel_lib.h"
+#include "platform.h"
+
+// #############################################################################
+//                           Frame Pacer Constants
+// #############################################################################
+// Vsync presents the frames, the pacer only starts the work as late as it can.
+// Rounded to a whole number of vblanks, 0 starts the work right after the last present
+constexpr int TARGET_FRAMES_PER_SECOND = 60;
+
+// The OS scheduler can wake us late, the last part of the wait is spent spinning
+constexpr long long FRAME_PACER_SPIN_NS = 1000000;
+// The work estimate is the slowest of the last N frames, so a spike keeps
+// the pacer careful for about two seconds. The first N frames run on vsync
+// alone, the shortest time between two presents is the refresh interval
+constexpr int FRAME_PACER_HISTORY_FRAMES = 120;
+// Headroom on top of the slowest frame, a quarter of it plus a fixed amount
+constexpr long long FRAME_PACER_MARGIN_DIVISOR = 4;
+constexpr long long FRAME_PACER_SAFETY_MARGIN_NS = 1000000;
+// Frame times are reported every N frames
+constexpr int FRAME_PACER_REPORT_FRAMES = 600;
+
+// #############################################################################
+//                           Frame Pacer Structs
+// #############################################################################
+struct FrameStats
+{
+  int frameCount;
+  double meanMs;
+  double m2; // Sum of squared differences from the mean (Welford)
+  double minMs;
+  double maxMs;
+  double overshootMs;
+};
+
+struct FramePacer
+{
+  long long targetFrameNs;
+  // Measured, 0 until the first FRAME_PACER_HISTORY_FRAMES are presented
+  long long refreshNs;
+  long long deadlineNs;
+  long long lastPresentNs;
+  long long workStartNs;
+  long long workEndNs;
+
+  // Input, update and render of the last frames, swap_buffers() is not
+  // part of it, it blocks until the vblank
+  long long workHistoryNs[FRAME_PACER_HISTORY_FRAMES];
+  long long shortestFrameNs;
+  int historyIdx;
+  int historyCount;
+
+  // The slowest frame in the history plus the margins
+  long long workEstimateNs;
+  // How much later than requested the OS wakes us up, smoothed
+  long long sleepOvershootNs;
+
+  FrameStats stats;
+};
+
+// #############################################################################
+//                           Frame Pacer Functions
+// #############################################################################
+FramePacer make_frame_pacer(int framesPerSecond)
+{
+  FramePacer framePacer = {};
+  if(framesPerSecond > 0)
+  {
+    framePacer.targetFrameNs = 1000000000LL / framesPerSecond;
+  }
+  framePacer.lastPresentNs = platform_get_time_ns();
+  framePacer.shortestFrameNs = 1000000000LL;
+  framePacer.stats.minMs = 1000.0;
+
+  return framePacer;
+}
+
+/*
+* Frame time variance, using Welford's online algorithm
+*/
+void frame_stats_add(FrameStats* stats, double frameMs)
+{
+  stats->frameCount++;
+  double delta = frameMs - stats->meanMs;
+  stats->meanMs += delta / stats->frameCount;
+  stats->m2 += delta * (frameMs - stats->meanMs);
+  stats->minMs = frameMs < stats->minMs? frameMs : stats->minMs;
+  stats->maxMs = frameMs > stats->maxMs? frameMs : stats->maxMs;
+}
+
+double frame_stats_variance(FrameStats* stats)
+{
+  return stats->frameCount > 1? stats->m2 / (stats->frameCount - 1) : 0.0;
+}
+
+/*
+* Sleeps until shortly before timeNs and spins the rest, returns the overshoot
+*/
+long long frame_pacer_sleep_until(FramePacer* framePacer, long long timeNs)
+{
+  long long overshoot = 0;
+  long long sleepUntil = timeNs - FRAME_PACER_SPIN_NS - framePacer->sleepOvershootNs;
+  if(sleepUntil > platform_get_time_ns())
+  {
+    platform_sleep_until(sleepUntil);
+
+    overshoot = max(platform_get_time_ns() - sleepUntil, 0LL);
+    framePacer->sleepOvershootNs += (overshoot - framePacer->sleepOvershootNs) / 8;
+  }
+
+  // Spin the rest, we don't trust the scheduler for the last bit
+  while(platform_get_time_ns() < timeNs)
+  {
+  }
+
+  return overshoot;
+}
+
+/*
+* Waits as long as possible before starting the next frame, input is
+* sampled and the simulation is run late, right before the vblank the
+* frame is presented at. This keeps the input to present latency low.
+* Never waits past the vblank before that one, the frame would be
+* presented early otherwise
+*/
+void frame_pacer_wait(FramePacer* framePacer)
+{
+  if(framePacer->deadlineNs)
+  {
+    long long wakeTime = max(framePacer->deadlineNs - framePacer->workEstimateNs,
+                             framePacer->deadlineNs - framePacer->refreshNs);
+    long long overshoot = frame_pacer_sleep_until(framePacer, wakeTime);
+    framePacer->stats.overshootMs += (double)overshoot / 1000000.0;
+  }
+
+  framePacer->workStartNs = platform_get_time_ns();
+}
+
+/*
+* Call this right before swapping the buffers
+*/
+void frame_pacer_begin_present(FramePacer* framePacer)
+{
+  framePacer->workEndNs = platform_get_time_ns();
+}
+
+/*
+* Call this right after swapping the buffers, vsync returns from the swap at the vblank
+*/
+void frame_pacer_end_frame(FramePacer* framePacer)
+{
+  long long now = platform_get_time_ns();
+  long long frameNs = now - framePacer->lastPresentNs;
+  framePacer->lastPresentNs = now;
+
+  // The slowest recent frame, not an average, one spike must not miss twice
+  framePacer->workHistoryNs[framePacer->historyIdx] = framePacer->workEndNs -
+                                                      framePacer->workStartNs;
+  framePacer->historyIdx = (framePacer->historyIdx + 1) % FRAME_PACER_HISTORY_FRAMES;
+  framePacer->historyCount = min(framePacer->historyCount + 1, FRAME_PACER_HISTORY_FRAMES);
+
+  long long slowestWorkNs = 0;
+  for(int historyIdx = 0; historyIdx < framePacer->historyCount; historyIdx++)
+  {
+    slowestWorkNs = max(slowestWorkNs, framePacer->workHistoryNs[historyIdx]);
+  }
+  framePacer->workEstimateNs = slowestWorkNs + slowestWorkNs / FRAME_PACER_MARGIN_DIVISOR +
+                               FRAME_PACER_SAFETY_MARGIN_NS;
+
+  // Measured while the work still starts right after the present, once
+  // the pacer waits, missed vblanks would make the frames look longer.
+  // The first frame started at make_frame_pacer(), not at a present
+  if(!framePacer->refreshNs && framePacer->historyCount > 1)
+  {
+    framePacer->shortestFrameNs = frameNs < framePacer->shortestFrameNs?
+                                  frameNs : framePacer->shortestFrameNs;
+    if(framePacer->historyCount == FRAME_PACER_HISTORY_FRAMES)
+    {
+      framePacer->refreshNs = framePacer->shortestFrameNs;
+    }
+  }
+
+  // A missed vblank moves the present, the next deadline follows it
+  if(framePacer->refreshNs && framePacer->targetFrameNs)
+  {
+    long long vblankCount = max((framePacer->targetFrameNs + framePacer->refreshNs / 2) /
+                                framePacer->refreshNs, 1LL);
+    framePacer->deadlineNs = now + vblankCount * framePacer->refreshNs;
+  }
+
+  FrameStats& stats = framePacer->stats;
+  frame_stats_add(&stats, (double)frameNs / 1000000.0);
+  if(stats.frameCount == FRAME_PACER_REPORT_FRAMES)
+  {
+    double variance = frame_stats_variance(&stats);
+    SM_TRACE("Frame Pacing: avg %.3fms, variance %.4fms^2, stddev %.3fms, min %.3fms, max %.3fms, "
+             "avg sleep overshoot %.3fms, work estimate %.3fms, refresh %.3fms",
+             stats.meanMs, variance, sqrt(variance), stats.minMs, stats.maxMs,
+             stats.overshootMs / stats.frameCount,
+             (double)framePacer->workEstimateNs / 1000000.0,
+             (double)framePacer->refreshNs / 1000000.0);
+
+    stats = {};
+    stats.minMs = 1000.0;
+  }
+}
@@ -301,14 +301,19 @@ void static update_player(float dt, bool enabledFriction, bool enabledGravity, b
           playerRect.pos.x += moveSign;
 
           // Update camera to follow player
-          renderData->gameCamera.position.x = player.pos.x;
+          renderData->cameras[CAMERA_GAME].position.x = player.pos.x;
 
           // Test collision against Solids
           {
-            for(int solidIdx = 0; solidIdx < gameState->solidsLevel1.count; solidIdx++)
+            for(int solidIdx = 0; solidIdx < gameState->solidsLevel1.slotsUsed; solidIdx++)
             {
-              Solid& solid = gameState->solidsLevel1[solidIdx];
-              IRect solidRect = get_solid_rect(solid);
+              Solid* solid = gameState->solidsLevel1.get_at(solidIdx);
+              if(!solid)
+              {
+                continue;
+              }
+
+              IRect solidRect = get_solid_rect(*solid);
 
               if(rect_collision(playerRect, solidRect))
               {
@@ -369,14 +374,19 @@ void static update_player(float dt, bool enabledFriction, bool enabledGravity, b
           playerRect.pos.y += moveSign;
 
           // Update camera to follow player
-          renderData->gameCamera.position.y = -player.pos.y;
+          renderData->cameras[CAMERA_GAME].position.y = -player.pos.y;
 
           // Test collision against Solids
           {
-            for(int solidIdx = 0; solidIdx < gameState->solidsLevel1.count; solidIdx++)
+            for(int solidIdx = 0; solidIdx < gameState->solidsLevel1.slotsUsed; solidIdx++)
             {
-              Solid& solid = gameState->solidsLevel1[solidIdx];
-              IRect solidRect = get_solid_rect(solid);
+              Solid* solid = gameState->solidsLevel1.get_at(solidIdx);
+              if(!solid)
+              {
+                continue;
+              }
+
+              IRect solidRect = get_solid_rect(*solid);
 
               if(rect_collision(playerRect, solidRect))
               {
@@ -435,27 +445,32 @@ void static update_solids_level_1(float dt)
   Player& player = gameState->player;
   player.solidSpeed = {};
 
-  for(int solidIdx = 0; solidIdx < gameState->solidsLevel1.count; solidIdx++)
+  for(int solidIdx = 0; solidIdx < gameState->solidsLevel1.slotsUsed; solidIdx++)
   {
-    Solid& solid = gameState->solidsLevel1[solidIdx];
-    solid.prevPos = solid.pos;
-    solid.keyframes[0] = gameState->player.pos;
+    Solid* solid = gameState->solidsLevel1.get_at(solidIdx);
+    if(!solid)
+    {
+      continue;
+    }
+
+    solid->prevPos = solid->pos;
+    solid->keyframes[0] = gameState->player.pos;
 
-    IRect solidRect = get_solid_rect(solid);
+    IRect solidRect = get_solid_rect(*solid);
     solidRect.pos -= 1;
     solidRect.size += 2;
 
-    int nextKeyframeIdx = solid.keyframeIdx + 1;
-    nextKeyframeIdx %= solid.keyframes.count;
+    int nextKeyframeIdx = solid->keyframeIdx + 1;
+    nextKeyframeIdx %= solid->keyframes.count;
 
 
     IRect playerRect = get_player_rect();
     int moveSignX, moveSignY;
-    if (playerRect.pos.x > solid.pos.x)
+    if (playerRect.pos.x > solid->pos.x)
     {
        moveSignX = 1;
     }
-    else if (playerRect.pos.x < solid.pos.x)
+    else if (playerRect.pos.x < solid->pos.x)
     {
       moveSignX = -1;
     }
@@ -464,11 +479,11 @@ void static update_solids_level_1(float dt)
       moveSignX = 0;
     }
 
-    if (playerRect.pos.y > solid.pos.y)
+    if (playerRect.pos.y > solid->pos.y)
     {
       moveSignY = 1;
     }
-    else if (playerRect.pos.y < solid.pos.y)
+    else if (playerRect.pos.y < solid->pos.y)
     {
       moveSignY = -1;
     }
@@ -486,11 +501,11 @@ void static update_solids_level_1(float dt)
 
     // Move X
     {
-      solid.remainder.x += solid.speed.x * dt;
-      int moveX = round(solid.remainder.x);
+      solid->remainder.x += solid->speed.x * dt;
+      int moveX = round(solid->remainder.x);
       if(moveX != 0)
       {
-        solid.remainder.x -= moveX;
+        solid->remainder.x -= moveX;
         // Move the player in Y until collision or moveY is exausted
         auto moveSolidX = [&]
         {
@@ -508,7 +523,7 @@ void static update_solids_level_1(float dt)
             {
               // Move the player rect
               playerRect.pos.x += moveSignX;
-              player.solidSpeed.x = solid.speed.x * (float)moveSignX / 20.0f;
+              player.solidSpeed.x = solid->speed.x * (float)moveSignX / 20.0f;
 
               // Check for collision, if yes, destroy the player
               // Loop through local Tiles
@@ -540,7 +555,7 @@ void static update_solids_level_1(float dt)
             }
 
             // Move the Solid
-            solid.pos.x += moveSignX;
+            solid->pos.x += moveSignX;
             moveX -= 1;
           }
         };
@@ -549,11 +564,11 @@ void static update_solids_level_1(float dt)
     }
     // Move Y
     {
-      solid.remainder.y += solid.speed.y * dt;
-      int moveY = round(solid.remainder.y);
+      solid->remainder.y += solid->speed.y * dt;
+      int moveY = round(solid->remainder.y);
       if(moveY != 0)
       {
-        solid.remainder.y -= moveY;
+        solid->remainder.y -= moveY;
         // Move the player in Y until collision or moveY is exausted
         auto moveSolidY = [&]
         {
@@ -571,7 +586,7 @@ void static update_solids_level_1(float dt)
             {
               // Move the player rect
               playerRect.pos.y += moveSignY;
-              player.solidSpeed.y = solid.speed.y * (float)moveSignY / 20.0f;
+              player.solidSpeed.y = solid->speed.y * (float)moveSignY / 20.0f;
 
               // Check for collision, if yes, destroy the player
               // Loop through local Tiles
@@ -603,7 +618,7 @@ void static update_solids_level_1(float dt)
             }
 
             // Move the Solid
-            solid.pos.y += moveSignY;
+            solid->pos.y += moveSignY;
             moveY -= 1;
           }
         };
@@ -611,13 +626,13 @@ void static update_solids_level_1(float dt)
       }
     }
     /*{
-      solid.remainder.x += solid.speed.x * dt;
-      int moveX = round(solid.remainder.x);
+      solid->remainder.x += solid->speed.x * dt;
+      int moveX = round(solid->remainder.x);
       if(moveX != 0)
       {
-        solid.remainder.x -= moveX;
-        int moveSign = sign(solid.keyframes[nextKeyframeIdx].x - 
-                            solid.keyframes[solid.keyframeIdx].x);
+        solid->remainder.x -= moveX;
+        int moveSign = sign(solid->keyframes[nextKeyframeIdx].x - 
+                            solid->keyframes[solid->keyframeIdx].x);
 
         // Move the player in Y until collision or moveY is exausted
         auto moveSolidX = [&]
@@ -636,7 +651,7 @@ void static update_solids_level_1(float dt)
             {
               // Move the player rect
               playerRect.pos.x += moveSign;
-              player.solidSpeed.x = solid.speed.x * (float)moveSign / 20.0f;
+              player.solidSpeed.x = solid->speed.x * (float)moveSign / 20.0f;
 
               // Check for collision, if yes, destroy the player
               // Loop through local Tiles
@@ -674,14 +689,14 @@ void static update_solids_level_1(float dt)
             }
 
             // Move the Solid
-            solid.pos.x += moveSign;
+            solid->pos.x += moveSign;
             moveX -= 1;
 
-            if(solid.pos.x == solid.keyframes[nextKeyframeIdx].x)
+            if(solid->pos.x == solid->keyframes[nextKeyframeIdx].x)
             {
-              solid.keyframeIdx = nextKeyframeIdx;
+              solid->keyframeIdx = nextKeyframeIdx;
               nextKeyframeIdx++;
-              nextKeyframeIdx %= solid.keyframes.count;
+              nextKeyframeIdx %= solid->keyframes.count;
             }
           }
         };
@@ -691,13 +706,13 @@ void static update_solids_level_1(float dt)
     /*
     // Move Y
     {
-      solid.remainder.y += solid.speed.y * dt;
-      int moveY = round(solid.remainder.y);
+      solid->remainder.y += solid->speed.y * dt;
+      int moveY = round(solid->remainder.y);
       if(moveY != 0)
       {
-        solid.remainder.y -= moveY;
-        int moveSign = sign(solid.keyframes[nextKeyframeIdx].y - 
-                            solid.keyframes[solid.keyframeIdx].y);
+        solid->remainder.y -= moveY;
+        int moveSign = sign(solid->keyframes[nextKeyframeIdx].y - 
+                            solid->keyframes[solid->keyframeIdx].y);
 
         // Move the player in Y until collision or moveY is exausted
         auto moveSolidY = [&]
@@ -712,7 +727,7 @@ void static update_solids_level_1(float dt)
             {
               // Move the player
               player.pos.y += moveSign;
-              player.solidSpeed.y = solid.speed.y * (float)moveSign / 40.0f;
+              player.solidSpeed.y = solid->speed.y * (float)moveSign / 40.0f;
 
               // Check for collision, if yes, destroy the player
               // Loop through local Tiles
@@ -738,14 +753,14 @@ void static update_solids_level_1(float dt)
             }
 
             // Move the Solid
-            solid.pos.y += moveSign;
+            solid->pos.y += moveSign;
             moveY -= 1;
 
-            if(solid.pos.y == solid.keyframes[nextKeyframeIdx].y)
+            if(solid->pos.y == solid->keyframes[nextKeyframeIdx].y)
             {
-              solid.keyframeIdx = nextKeyframeIdx;
+              solid->keyframeIdx = nextKeyframeIdx;
               nextKeyframeIdx++;
-              nextKeyframeIdx %= solid.keyframes.count;
+              nextKeyframeIdx %= solid->keyframes.count;
             }
           }
         };
@@ -759,27 +774,32 @@ void static update_solids_level_2(float dt)
   Player& player = gameState->player;
   player.solidSpeed = {};
 
-  for(int solidIdx = 0; solidIdx < gameState->solidsLevel2.count; solidIdx++)
+  for(int solidIdx = 0; solidIdx < gameState->solidsLevel2.slotsUsed; solidIdx++)
   {
-    Solid& solid = gameState->solidsLevel2[solidIdx];
-    solid.prevPos = solid.pos;
+    Solid* solid = gameState->solidsLevel2.get_at(solidIdx);
+    if(!solid)
+    {
+      continue;
+    }
+
+    solid->prevPos = solid->pos;
 
-    IRect solidRect = get_solid_rect(solid);
+    IRect solidRect = get_solid_rect(*solid);
     solidRect.pos -= 1;
     solidRect.size += 2;
 
-    int nextKeyframeIdx = solid.keyframeIdx + 1;
-    nextKeyframeIdx %= solid.keyframes.count;
+    int nextKeyframeIdx = solid->keyframeIdx + 1;
+    nextKeyframeIdx %= solid->keyframes.count;
 
     // Move X
     {
-      solid.remainder.x += solid.speed.x * dt;
-      int moveX = round(solid.remainder.x);
+      solid->remainder.x += solid->speed.x * dt;
+      int moveX = round(solid->remainder.x);
       if(moveX != 0)
       {
-        solid.remainder.x -= moveX;
-        int moveSign = sign(solid.keyframes[nextKeyframeIdx].x - 
-                            solid.keyframes[solid.keyframeIdx].x);
+        solid->remainder.x -= moveX;
+        int moveSign = sign(solid->keyframes[nextKeyframeIdx].x - 
+                            solid->keyframes[solid->keyframeIdx].x);
 
         // Move the player in Y until collision or moveY is exausted
         auto moveSolidX = [&]
@@ -798,7 +818,7 @@ void static update_solids_level_2(float dt)
             {
               // Move the player rect
               playerRect.pos.x += moveSign;
-              player.solidSpeed.x = solid.speed.x * (float)moveSign / 20.0f;
+              player.solidSpeed.x = solid->speed.x * (float)moveSign / 20.0f;
 
               // Check for collision, if yes, destroy the player
               // Loop through local Tiles
@@ -836,14 +856,14 @@ void static update_solids_level_2(float dt)
             }
 
             // Move the Solid
-            solid.pos.x += moveSign;
+            solid->pos.x += moveSign;
             moveX -= 1;
 
-            if(solid.pos.x == solid.keyframes[nextKeyframeIdx].x)
+            if(solid->pos.x == solid->keyframes[nextKeyframeIdx].x)
             {
-              solid.keyframeIdx = nextKeyframeIdx;
+              solid->keyframeIdx = nextKeyframeIdx;
               nextKeyframeIdx++;
-              nextKeyframeIdx %= solid.keyframes.count;
+              nextKeyframeIdx %= solid->keyframes.count;
             }
           }
         };
@@ -853,13 +873,13 @@ void static update_solids_level_2(float dt)
 
     // Move Y
     {
-      solid.remainder.y += solid.speed.y * dt;
-      int moveY = round(solid.remainder.y);
+      solid->remainder.y += solid->speed.y * dt;
+      int moveY = round(solid->remainder.y);
       if(moveY != 0)
       {
-        solid.remainder.y -= moveY;
-        int moveSign = sign(solid.keyframes[nextKeyframeIdx].y - 
-                            solid.keyframes[solid.keyframeIdx].y);
+        solid->remainder.y -= moveY;
+        int moveSign = sign(solid->keyframes[nextKeyframeIdx].y - 
+                            solid->keyframes[solid->keyframeIdx].y);
 
         // Move the player in Y until collision or moveY is exausted
         auto moveSolidY = [&]
@@ -874,7 +894,7 @@ void static update_solids_level_2(float dt)
             {
               // Move the player
               player.pos.y += moveSign;
-              player.solidSpeed.y = solid.speed.y * (float)moveSign / 40.0f;
+              player.solidSpeed.y = solid->speed.y * (float)moveSign / 40.0f;
 
               // Check for collision, if yes, destroy the player
               // Loop through local Tiles
@@ -900,14 +920,14 @@ void static update_solids_level_2(float dt)
             }
 
             // Move the Solid
-            solid.pos.y += moveSign;
+            solid->pos.y += moveSign;
             moveY -= 1;
 
-            if(solid.pos.y == solid.keyframes[nextKeyframeIdx].y)
+            if(solid->pos.y == solid->keyframes[nextKeyframeIdx].y)
             {
-              solid.keyframeIdx = nextKeyframeIdx;
+              solid->keyframeIdx = nextKeyframeIdx;
               nextKeyframeIdx++;
-              nextKeyframeIdx %= solid.keyframes.count;
+              nextKeyframeIdx %= solid->keyframes.count;
             }
           }
         };
@@ -931,14 +951,28 @@ void static update_solids(float dt)
 
 void static update_projectiles(float dt)
 {
-  /*Player& player = gameState->player;
-  player.solidSpeed = {};
+  Player& player = gameState->player;
 
-  for(int projectileIdx = 0; projectileIdx < gameState->projectiles.count; projectileIdx++)
+  for(int projectileIdx = 0; projectileIdx < gameState->projectiles.slotsUsed; projectileIdx++)
   {
-    Solid& projectile = gameState->projectiles[projectileIdx];
-    projectile.pos.x += 1;
-  }*/
+    Solid* projectile = gameState->projectiles.get_at(projectileIdx);
+    if(!projectile)
+    {
+      continue;
+    }
+
+    projectile->prevPos = projectile->pos;
+    projectile->remainder.x += projectile->speed.x;
+    int moveX = round(projectile->remainder.x);
+    projectile->remainder.x -= moveX;
+    projectile->pos.x += moveX;
+
+    // Removing doesn't move the other Projectiles, so we can keep iterating
+    if(abs(projectile->pos.x - player.pos.x) > WORLD_WIDTH)
+    {
+      gameState->projectiles.remove(gameState->projectiles.get_handle(projectileIdx));
+    }
+  }
 }
 
 void update_level(float dt)
@@ -990,11 +1024,13 @@ void update_level(float dt)
 
   // Update camera to follow player
   Player& player = gameState->player;
-  renderData->gameCamera.position.x = player.pos.x;
-  renderData->gameCamera.position.y = -player.pos.y;
+  renderData->cameras[CAMERA_GAME].position.x = player.pos.x;
+  renderData->cameras[CAMERA_GAME].position.y = -player.pos.y;
 
   // Update Solids
   update_solids(dt);
+
+  update_projectiles(dt);
 }
 
 void update_main_menu(float dt)
@@ -1080,6 +1116,7 @@ EXPORT_FN void update_game(GameState* gameStateIn,
                            Input* inputIn, 
                            SoundState* soundStateIn,
                            UIState* uiStateIn,
+                           StringInterner* stringInternerIn,
                            float dt)
 {
   if(renderData != renderDataIn)
@@ -1089,6 +1126,7 @@ EXPORT_FN void update_game(GameState* gameStateIn,
     input = inputIn;
     soundState = soundStateIn;
     uiState = uiStateIn;
+    stringInterner = stringInternerIn;
 
     init_strings();
   }
@@ -1096,13 +1134,15 @@ EXPORT_FN void update_game(GameState* gameStateIn,
   if(!gameState->initialized)
   {
     play_sound("First Steps", SOUND_OPTION_LOOP);
-    renderData->gameCamera.dimensions = {WORLD_WIDTH, WORLD_HEIGHT};
-    renderData->gameCamera.position.x = (WORLD_WIDTH / 2);
-    renderData->gameCamera.position.y = -(WORLD_HEIGHT / 2);
+    renderData->cameras[CAMERA_GAME].zoom = 1.0f;
+    renderData->cameras[CAMERA_GAME].dimensions = {WORLD_WIDTH, WORLD_HEIGHT};
+    renderData->cameras[CAMERA_GAME].position.x = (WORLD_WIDTH / 2);
+    renderData->cameras[CAMERA_GAME].position.y = -(WORLD_HEIGHT / 2);
 
-    renderData->uiCamera.dimensions = {WORLD_WIDTH, WORLD_HEIGHT};
-    renderData->uiCamera.position.x = (WORLD_WIDTH / 2);
-    renderData->uiCamera.position.y = -(WORLD_HEIGHT / 2);
+    renderData->cameras[CAMERA_UI].zoom = 1.0f;
+    renderData->cameras[CAMERA_UI].dimensions = {WORLD_WIDTH, WORLD_HEIGHT};
+    renderData->cameras[CAMERA_UI].position.x = (WORLD_WIDTH / 2);
+    renderData->cameras[CAMERA_UI].position.y = -(WORLD_HEIGHT / 2);
 
     // Player
     {
@@ -1219,11 +1259,30 @@ EXPORT_FN void update_game(GameState* gameStateIn,
 
   // Draw solids
   {
-    for(int solidIdx = 0; solidIdx < gameState->solidsLevel1.count; solidIdx++)
+    // Positions are gathered, so they can be interpolated all at once
+    int solidCount = 0;
+    int slotCount = gameState->solidsLevel1.slotsUsed;
+    TempArenaScope scratch(get_scratch());
+    Solid** solids = (Solid**)bump_alloc(scratch.arena(), sizeof(Solid*) * slotCount);
+    IVec2* solidPositions = (IVec2*)bump_alloc(scratch.arena(), sizeof(IVec2) * slotCount * 2);
+    IVec2* prevSolidPositions = solidPositions + slotCount;
+    for(int solidIdx = 0; solidIdx < slotCount; solidIdx++)
+    {
+      Solid* solid = gameState->solidsLevel1.get_at(solidIdx);
+      if(solid)
+      {
+        solids[solidCount] = solid;
+        solidPositions[solidCount] = solid->pos;
+        prevSolidPositions[solidCount] = solid->prevPos;
+        solidCount++;
+      }
+    }
+    lerp_batch(solidPositions, prevSolidPositions, solidPositions, interpolatedDT, solidCount);
+
+    for(int solidIdx = 0; solidIdx < solidCount; solidIdx++)
     {
-      Solid& solid = gameState->solidsLevel1[solidIdx];
-      IVec2 solidPos = lerp(solid.prevPos, solid.pos, interpolatedDT);
-      draw_sprite(solid.spriteID, solidPos, {.layer = get_layer(LAYER_GAME, 1)});
+      draw_sprite(solids[solidIdx]->spriteID, solidPositions[solidIdx], 
+                  {.layer = get_layer(LAYER_GAME, 1)});
     }
   }
 
@@ -1244,8 +1303,15 @@ EXPORT_FN void update_game(GameState* gameStateIn,
 
   // Draw projectiles
   {
-    /*Player& player = gameState->player;
-    draw_sprite(SPRITE_BASIC_PROJECTILE, player.pos, {.layer = get_layer(LAYER_GAME, 2)});*/
+    for(int projectileIdx = 0; projectileIdx < gameState->projectiles.slotsUsed; projectileIdx++)
+    {
+      Solid* projectile = gameState->projectiles.get_at(projectileIdx);
+      if(projectile)
+      {
+        IVec2 projectilePos = lerp(projectile->prevPos, projectile->pos, interpolatedDT);
+        draw_sprite(projectile->spriteID, projectilePos, {.layer = get_layer(LAYER_GAME, 2)});
+      }
+    }
   }
 }
 
@@ -1253,4 +1319,10 @@ EXPORT_FN void game_init(std::function<void(const std::string&)> callback)
 {
   // Initialize necessary projectiles into game
   switchAtlasCallback = callback;
+}
+
+EXPORT_FN void game_unload()
+{
+  // The Scratch Arenas of this library would be lost with it
+  release_scratch_arenas();
 }
\ No newline at end of file
@@ -23,6 +23,10 @@ constexpr int NUM_OF_TILE_ROWS = 7;
 constexpr int NUM_OF_TILE_COLUMNS = 9;
 constexpr int GRID_RADIUS = 5;
 constexpr IVec2 WORLD_GRID = {NUM_OF_TILE_COLUMNS, NUM_OF_TILE_ROWS};
+constexpr int MAX_SOLIDS = 20;
+// Enemies and Projectiles are created and destroyed all the time
+constexpr int MAX_ENEMIES = 64;
+constexpr int MAX_PROJECTILES = 256;
 
 // #############################################################################
 //                           Game Structs
@@ -99,17 +103,18 @@ struct GameState
   bool initialized = false;
 
   Player player;
-  // Level 1 Solids
-  Array<Solid, 20> solidsLevel1;
+  // Level 1 Solids, Pools so PoolHandles to them stay valid when one is removed
+  Pool<Solid, MAX_SOLIDS> solidsLevel1;
   Array<IRect, NUM_OF_TILE_ROWS * NUM_OF_TILE_COLUMNS> backgroundTiles;
 
-  // Level 1 Enemies
-  Array<Solid, 5> enemiesLevel1;
+  // Level 1 Enemies, removed by PoolHandle, the others keep their slots
+  Pool<Solid, MAX_ENEMIES> enemiesLevel1;
 
   // Level 2 Solids
-  Array<Solid, 20> solidsLevel2;
-  
-  Array<Solid, 5> projectiles;
+  Pool<Solid, MAX_SOLIDS> solidsLevel2;
+
+  // Removed by PoolHandle once they left the screen, see update_projectiles()
+  Pool<Solid, MAX_PROJECTILES> projectiles;
 
   Array<IVec2, 21> tileCoords;
   Tile worldGrid[WORLD_GRID.x][WORLD_GRID.y];
@@ -134,9 +139,13 @@ extern "C"
                              Input* inputIn, 
                              SoundState* soundStateIn,
                              UIState* uiStateIn,
+                             StringInterner* stringInternerIn,
                              float dt);
 
   EXPORT_FN void game_init(std::function<void(const std::string&)> callback);
+
+  // Called on the main Thread right before the library is unloaded
+  EXPORT_FN void game_unload();
 }
 
 /**
@@ -3,46 +3,99 @@
 
 // To Load PNG Files
 #define STB_IMAGE_IMPLEMENTATION
-#include "stb_image.h"
+#include "cooked_texture.h"
+#include "cooked_shader.h"
 
 // To Load TTF Files
 #include <ft2build.h>
 #include FT_FREETYPE_H
 
-#include <map>
 #include <string>
 
 
 // #############################################################################
 //                           OpenGL Constants
 // #############################################################################
-const char* MASTER_TEXTURE_PATH = "assets/textures/TEXTURE_ATLAS.png";
-const char* PROJECTILES_MASTER_TEXTURE_PATH = "assets/textures/TEXTURE_ATLAS_PROJECTILES.png";
-const char* ENEMIES_MASTER_TEXTURE_PATH = "assets/textures/TEXTURE_ATLAS_ENEMIES.png";
+const char* MASTER_TEXTURE_PATH = ATLAS_TEXTURE_PATHS[ATLAS_MASTER];
+
+// Uploads don't touch the Units the Shaders read from, see shader_header.h
+constexpr GLenum UPLOAD_TEXTURE_UNIT = GL_TEXTURE0 + ATLAS_TEXTURE_UNIT + MAX_ATLASES;
+static_assert(ATLAS_COUNT <= MAX_ATLASES, "Not enough Texture Units for the Atlases");
+
+// Atlases are loaded when first drawn. Once the resident Atlases use more than the
+// budget, the ones not drawn for the delay are evicted, least recently used first
+constexpr long long ATLAS_VRAM_BUDGET = MB(8);
+constexpr long long ATLAS_EVICT_DELAY_FRAMES = 600;
 
 
 // #############################################################################
 //                           OpenGL Structs
 // #############################################################################
+struct AtlasSlot
+{
+  AssetHandle handle; // INVALID_ASSET_HANDLE until first drawn
+  long long lastUsedFrame;
+
+  // Hot Reloading, see file_watcher.h
+  int watchIdx;
+  // Changed before it was ever loaded, the Asset Pack has the old version
+  bool reloadOnLoad;
+};
+
+struct AtlasResidency
+{
+  // Defaults to the constants above, can be changed at runtime
+  long long vramBudget;
+  long long evictDelayFrames;
+
+  long long frameIdx;
+  AtlasSlot atlases[ATLAS_COUNT];
+  // 1x1 transparent, bound to the Units of Atlases that aren't resident
+  GLuint emptyTextureID;
+};
+
+/*
+* The Shaders and the Program are compiled and linked by the driver in the
+* background, the Program is only looked at once the driver is done
+*/
+struct ShaderCompile
+{
+  GLuint vertShaderID;
+  GLuint fragShaderID;
+  GLuint programID; // 0 if nothing is compiling
+  long long startNs;
+};
+
 struct GLContext
 {
   GLuint programID;
-  GLuint textureID;
   GLuint transformSBOID;
   GLuint materialSBOID;
+  GLuint cameraUBOID;
   GLuint screenSizeID;
-  GLuint orthoProjectionID;
   GLuint fontAtlasID;
 
-  long long textureTimestamp;
-  long long shaderTimestamp;
+  // Requested before the Window exists, see gl_request_startup_assets()
+  AssetHandle startupAssets[2];
+
+  // GL_KHR_parallel_shader_compile, without it the first status query blocks
+  bool parallelShaderCompile;
+  // Hot Reloading, the current Program stays in use until this one linked
+  ShaderCompile shaderCompile;
+
+  // Hot Reloading, see file_watcher.h
+  int shaderHeaderWatchIdx;
+  int vertShaderWatchIdx;
+  int fragShaderWatchIdx;
 };
 
 // #############################################################################
 //                           OpenGL Globals
 // #############################################################################
 static GLContext glContext;
-std::map<std::string, GLuint> textureAtlases;
+static AtlasResidency atlasResidency;
+// Interned Atlas name -> AtlasID
+HashMap<unsigned int, int> textureAtlases;
 
 // #############################################################################
 //                           OpenGL Functions
@@ -50,6 +103,12 @@ std::map<std::string, GLuint> textureAtlases;
 static void APIENTRY gl_debug_callback(GLenum source, GLenum type, GLuint id, GLenum severity,
                                          GLsizei length, const GLchar* message, const void* user)
 {
+  // Reported with the info log once the compile is done, see gl_finish_shader_compile()
+  if(source == GL_DEBUG_SOURCE_SHADER_COMPILER)
+  {
+    return;
+  }
+
   if(severity == GL_DEBUG_SEVERITY_LOW || 
      severity == GL_DEBUG_SEVERITY_MEDIUM ||
      severity == GL_DEBUG_SEVERITY_HIGH)
@@ -58,96 +117,265 @@ static void APIENTRY gl_debug_callback(GLenum source, GLenum type, GLuint id, GL
   }
   else
   {
-    SM_TRACE((char*)message);
+    SM_TRACE("%s", message);
   }
 }
 
-GLuint gl_create_shader(int shaderType, char* shaderPath, BumpAllocator* transientStorage)
+/*
+* Only hands the source to the driver, errors are reported by gl_finish_shader_compile().
+* Returns 0 if the source can't be read. Hot Reloading sets loose and compiles the
+* loose files, the Asset Pack only has the ones from the last cook
+*/
+GLuint gl_compile_shader(int shaderType, char* shaderPath, bool loose = false)
 {
-  int fileSize = 0;
-  char* shaderHeader = read_file("src/shader_header.h", &fileSize, transientStorage);
-  char* shaderSource = read_file(shaderPath, &fileSize, transientStorage);
-  if(!shaderHeader)
+  // The Cooker already inlined everything, the driver gets it in one piece
+  char cookedPath[256] = {};
+  get_cooked_shader_path(shaderPath, cookedPath, sizeof(cookedPath));
+  AssetFile cookedShader = {};
+  if(!loose && find_asset_pack_entry(cookedPath))
   {
-    SM_ASSERT(false, "Failed to load shader_header.h");
-    return 0;
+    cookedShader = open_asset_file(cookedPath, FILE_ACCESS_SEQUENTIAL);
   }
-  if(!shaderSource)
+
+  // The sources are read in place, until glShaderSource() copied them
+  AssetFile shaderHeader = {};
+  AssetFile shaderSource = {};
+  if(!cookedShader.data)
   {
-    SM_ASSERT(false, "Failed to load shader: %s",shaderPath);
-    return 0;
+    shaderHeader = open_asset_file(SHADER_HEADER_PATH, FILE_ACCESS_SEQUENTIAL, true);
+    shaderSource = open_asset_file(shaderPath, FILE_ACCESS_SEQUENTIAL, true);
+    if(!shaderHeader.data)
+    {
+      close_asset_file(&shaderSource);
+      SM_ERROR("Failed to load shader_header.h");
+      return 0;
+    }
+    if(!shaderSource.data)
+    {
+      close_asset_file(&shaderHeader);
+      SM_ERROR("Failed to load shader: %s", shaderPath);
+      return 0;
+    }
   }
 
+  // Mapped files are not zero terminated, so every length is supplied
   char* shaderSources[] =
   {
-    "#version 430 core\r\n",
-    shaderHeader,
-    shaderSource
+    (char*)SHADER_VERSION_LINE,
+    shaderHeader.data,
+    shaderSource.data
+  };
+  GLint shaderSourceLengths[] =
+  {
+    -1, // Zero terminated
+    (GLint)shaderHeader.size,
+    (GLint)shaderSource.size
   };
+  if(cookedShader.data)
+  {
+    shaderSources[0] = cookedShader.data;
+    shaderSourceLengths[0] = (GLint)cookedShader.size;
+  }
 
   GLuint shaderID = glCreateShader(shaderType);
-  glShaderSource(shaderID, ArraySize(shaderSources), shaderSources, 0);
+  glShaderSource(shaderID, cookedShader.data? 1 : ArraySize(shaderSources), 
+                 shaderSources, shaderSourceLengths);
   glCompileShader(shaderID);
 
-  // Test if Shader compiled successfully 
+  close_asset_file(&cookedShader);
+  close_asset_file(&shaderHeader);
+  close_asset_file(&shaderSource);
+
+  return shaderID;
+}
+
+bool gl_has_extension(const char* extension)
+{
+  GLint extensionCount = 0;
+  glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+  for(int extensionIdx = 0; extensionIdx < extensionCount; extensionIdx++)
   {
-    int success;
-    char shaderLog[2048] = {};
+    if(strcmp((const char*)glGetStringi(GL_EXTENSIONS, extensionIdx), extension) == 0)
+    {
+      return true;
+    }
+  }
+  return false;
+}
 
-    glGetShaderiv(shaderID, GL_COMPILE_STATUS, &success);
-    if(!success)
+void gl_cancel_shader_compile(ShaderCompile* compile)
+{
+  if(!compile->programID)
+  {
+    return;
+  }
+
+  // The driver finishes on it's own and throws the result away
+  glDeleteShader(compile->vertShaderID);
+  glDeleteShader(compile->fragShaderID);
+  glDeleteProgram(compile->programID);
+  *compile = {};
+}
+
+/*
+* Returns immediately if the driver compiles in parallel, check
+* gl_shader_compile_done() before gl_finish_shader_compile()
+*/
+ShaderCompile gl_begin_shader_compile(bool loose = false)
+{
+  ShaderCompile compile = {};
+  compile.startNs = platform_get_time_ns();
+  compile.vertShaderID = gl_compile_shader(GL_VERTEX_SHADER, "assets/shaders/quad.vert", loose);
+  compile.fragShaderID = gl_compile_shader(GL_FRAGMENT_SHADER, "assets/shaders/quad.frag", loose);
+  if(!compile.vertShaderID || !compile.fragShaderID)
+  {
+    // Deleting 0 is ignored
+    glDeleteShader(compile.vertShaderID);
+    glDeleteShader(compile.fragShaderID);
+    return {};
+  }
+
+  // Linking is queued behind the compiles, nothing waits for them here
+  compile.programID = glCreateProgram();
+  glAttachShader(compile.programID, compile.vertShaderID);
+  glAttachShader(compile.programID, compile.fragShaderID);
+  glLinkProgram(compile.programID);
+
+  return compile;
+}
+
+bool gl_shader_compile_done(ShaderCompile* compile)
+{
+  if(!glContext.parallelShaderCompile)
+  {
+    return true;
+  }
+
+  GLint done = 0;
+  glGetProgramiv(compile->programID, GL_COMPLETION_STATUS_KHR, &done);
+  return done;
+}
+
+/*
+* Returns the linked Program, or 0 after logging the errors. Cleans up the compile either way
+*/
+GLuint gl_finish_shader_compile(ShaderCompile* compile)
+{
+  if(!compile->programID)
+  {
+    return 0;
+  }
+
+  bool success = true;
+  GLuint shaderIDs[] = {compile->vertShaderID, compile->fragShaderID};
+  const char* shaderNames[] = {"quad.vert", "quad.frag"};
+  for(int shaderIdx = 0; shaderIdx < ArraySize(shaderIDs); shaderIdx++)
+  {
+    GLint compiled = 0;
+    glGetShaderiv(shaderIDs[shaderIdx], GL_COMPILE_STATUS, &compiled);
+    if(!compiled)
     {
-      glGetShaderInfoLog(shaderID, 2048, 0, shaderLog);
-      SM_ASSERT(false, "Failed to compile %s Shader, Error: %s", shaderPath, shaderLog);
-      return 0;
+      char shaderLog[2048] = {};
+      glGetShaderInfoLog(shaderIDs[shaderIdx], sizeof(shaderLog), 0, shaderLog);
+      SM_ERROR("Failed to compile %s, Error: %s", shaderNames[shaderIdx], shaderLog);
+      success = false;
     }
   }
 
-  return shaderID;
+  // A failed compile always fails the link, it's log adds nothing
+  GLint linked = 0;
+  glGetProgramiv(compile->programID, GL_LINK_STATUS, &linked);
+  if(success && !linked)
+  {
+    char programLog[2048] = {};
+    glGetProgramInfoLog(compile->programID, sizeof(programLog), 0, programLog);
+    SM_ERROR("Failed to link program: %s", programLog);
+  }
+  success = success && linked;
+
+  glDetachShader(compile->programID, compile->vertShaderID);
+  glDetachShader(compile->programID, compile->fragShaderID);
+  glDeleteShader(compile->vertShaderID);
+  glDeleteShader(compile->fragShaderID);
+
+  GLuint programID = compile->programID;
+  if(!success)
+  {
+    glDeleteProgram(programID);
+    programID = 0;
+  }
+  else
+  {
+    SM_TRACE("Compiled Shaders in %.2fms", 
+             (double)(platform_get_time_ns() - compile->startNs) / 1000000.0);
+  }
+
+  *compile = {};
+  return programID;
 }
 
-void load_font(char* filePath, int fontSize)
+// Rasterized by a Worker, see decode_font_asset()
+constexpr int FONT_ATLAS_SIZE = 512;
+struct DecodedFont
+{
+  int fontHeight;
+  Glyph glyphs[127];
+  char pixels[FONT_ATLAS_SIZE * FONT_ATLAS_SIZE];
+};
+
+bool decode_font_asset(Asset* asset)
 {
+  int fontSize = asset->param;
+
   FT_Library fontLibrary;
   FT_Init_FreeType(&fontLibrary);
 
+  // FreeType reads the glyphs in place, the file has to stay open until FT_Done_Face()
+  AssetFile fontFile = open_asset_file(asset->path, FILE_ACCESS_RANDOM, asset->loose);
+  if(!fontFile.data)
+  {
+    SM_ERROR("Failed to load Font: %s", asset->path);
+    FT_Done_FreeType(fontLibrary);
+    return false;
+  }
+
   FT_Face fontFace;
-  FT_New_Face(fontLibrary, filePath, 0, &fontFace);
+  FT_New_Memory_Face(fontLibrary, (FT_Byte*)fontFile.data, (FT_Long)fontFile.size, 0, &fontFace);
   FT_Set_Pixel_Sizes(fontFace, 0, fontSize);
 
   int padding = 2;
   int row = 0;
   int col = padding;
 
-  const int textureWidth = 512;
-  char textureBuffer[textureWidth  * textureWidth];
+  DecodedFont* font = (DecodedFont*)malloc(sizeof(DecodedFont));
+  memset(font, 0, sizeof(DecodedFont));
   for (FT_ULong glyphIdx = 32; glyphIdx < 127; ++glyphIdx)
   {
     FT_UInt glyphIndex = FT_Get_Char_Index(fontFace, glyphIdx);
     FT_Load_Glyph(fontFace, glyphIndex, FT_LOAD_DEFAULT);
     FT_Error error = FT_Render_Glyph(fontFace->glyph, FT_RENDER_MODE_NORMAL);
 
-    if (col + fontFace->glyph->bitmap.width + padding >= 512)
+    if (col + fontFace->glyph->bitmap.width + padding >= FONT_ATLAS_SIZE)
     {
       col = padding;
       row += fontSize;
     }
 
     // Font Height
-    renderData->fontHeight = 
+    font->fontHeight = 
       max((fontFace->size->metrics.ascender - fontFace->size->metrics.descender) >> 6, 
-          renderData->fontHeight);
+          font->fontHeight);
 
     for (unsigned int y = 0; y < fontFace->glyph->bitmap.rows; ++y)
     {
       for (unsigned int x = 0; x < fontFace->glyph->bitmap.width; ++x)
       {
-        textureBuffer[(row + y) * textureWidth + col + x] =
+        font->pixels[(row + y) * FONT_ATLAS_SIZE + col + x] =
             fontFace->glyph->bitmap.buffer[y * fontFace->glyph->bitmap.width + x];
       }
     }
 
-    Glyph* glyph = &renderData->glyphs[glyphIdx];
+    Glyph* glyph = &font->glyphs[glyphIdx];
     glyph->textureCoords = {col, row};
     glyph->size = 
     { 
@@ -170,36 +398,126 @@ void load_font(char* filePath, int fontSize)
 
   FT_Done_Face(fontFace);
   FT_Done_FreeType(fontLibrary);
+  close_asset_file(&fontFile);
+
+  asset->decoded = font;
+  return true;
+}
+
+bool finalize_font_asset(Asset* asset)
+{
+  DecodedFont* font = (DecodedFont*)asset->decoded;
+
+  // The UI only sees complete Fonts, they are swapped in on the main thread
+  renderData->fontHeight = font->fontHeight;
+  memcpy(renderData->glyphs, font->glyphs, sizeof(font->glyphs));
 
   // Upload OpenGL Texture
   {
-    glGenTextures(1, (GLuint*)&glContext.fontAtlasID);
-    glActiveTexture(GL_TEXTURE1); // Bound to binding = 1, see quad.frag
-    glBindTexture(GL_TEXTURE_2D, glContext.fontAtlasID);
+    if(!glContext.fontAtlasID)
+    {
+      glGenTextures(1, (GLuint*)&glContext.fontAtlasID);
+    }
+    gl_bind_texture(GL_TEXTURE0 + FONT_TEXTURE_UNIT, glContext.fontAtlasID);
 
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, textureWidth, textureWidth, 0, 
-                 GL_RED, GL_UNSIGNED_BYTE, (char*)textureBuffer);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, FONT_ATLAS_SIZE, FONT_ATLAS_SIZE, 0, 
+                 GL_RED, GL_UNSIGNED_BYTE, font->pixels);
 
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
   }
+
+  asset->textureID = glContext.fontAtlasID;
+  asset->size = FONT_ATLAS_SIZE * FONT_ATLAS_SIZE;
+  return true;
 }
 
-GLuint load_texture_with_stbi(const char* texturePath)
+/*
+* Reads the cooked Texture, out of the Asset Pack or the loose file. The PNG is only
+* decoded if the loose cooked file is missing or outdated. The pixels are read in here,
+* not in the upload
+*/
+bool decode_texture_asset(Asset* asset)
 {
-  int width, height, channels;
-  char* data = (char*)stbi_load(texturePath, &width, &height, &channels, 4);
-  if(!data)
+  char cookedPath[256] = {};
+  get_cooked_texture_path(asset->path, cookedPath, sizeof(cookedPath));
+
+  // Packed Textures are cooked together with the pack, they are never outdated
+  if(!asset->loose && find_asset_pack_entry(cookedPath))
   {
-    SM_ASSERT(false, "Failed to load texture");
+    AssetFile file = open_asset_file(cookedPath, FILE_ACCESS_SEQUENTIAL);
+    CookedTextureHeader* header = (CookedTextureHeader*)file.data;
+    if(file.size < (long long)sizeof(CookedTextureHeader) ||
+       !get_cooked_texture_header(file.data, file.size, header->sourceTimestamp))
+    {
+      close_asset_file(&file);
+      return false;
+    }
+
+    touch_file_view({file.data, file.size});
+    asset->file = file;
+    return true;
+  }
+
+  long long sourceTimestamp = get_timestamp(asset->path);
+
+  AssetFile file = open_asset_file(cookedPath, FILE_ACCESS_SEQUENTIAL, true);
+  CookedTextureHeader* header = get_cooked_texture_header(file.data, file.size, sourceTimestamp);
+  if(!header)
+  {
+    close_asset_file(&file);
+
+    if(cook_texture(asset->path))
+    {
+      file = open_asset_file(cookedPath, FILE_ACCESS_SEQUENTIAL, true);
+      header = get_cooked_texture_header(file.data, file.size, sourceTimestamp);
+    }
+  }
+
+  if(!header)
+  {
+    close_asset_file(&file);
+    return false;
+  }
+
+  touch_file_view({file.data, file.size});
+  asset->file = file;
+  return true;
+}
+
+bool finalize_texture_asset(Asset* asset)
+{
+  CookedTextureHeader* header = (CookedTextureHeader*)asset->file.data;
+
+  // Hot Reloads upload into the Texture the Asset already has,
+  // nothing has to be rebound and nothing leaks
+  GLuint textureID = asset->textureID;
+  if(textureID)
+  {
+    gl_bind_texture(UPLOAD_TEXTURE_UNIT, textureID);
+
+    GLint width = 0;
+    GLint height = 0;
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &width);
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &height);
+    if(width == header->width && height == header->height)
+    {
+      glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, header->width, header->height, 
+                      GL_RGBA, GL_UNSIGNED_BYTE, header + 1);
+    }
+    else
+    {
+      // Resized, the storage is replaced in place
+      glTexImage2D(GL_TEXTURE_2D, 0, GL_SRGB8_ALPHA8, header->width, header->height, 
+                   0, GL_RGBA, GL_UNSIGNED_BYTE, header + 1);
+    }
   }
   else
   {
-    glGenTextures(1, &glContext.textureID);
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, glContext.textureID);
+    glGenTextures(1, &textureID);
+    gl_bind_texture(UPLOAD_TEXTURE_UNIT, textureID);
 
     // set the texture wrapping/filtering options (on the currently bound texture object)
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -211,24 +529,124 @@ GLuint load_texture_with_stbi(const char* texturePath)
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_SRGB8_ALPHA8, width, height, 
-                  0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-    glContext.textureTimestamp = get_timestamp(texturePath);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_SRGB8_ALPHA8, header->width, header->height, 
+                 0, GL_RGBA, GL_UNSIGNED_BYTE, header + 1);
   }
 
-  stbi_image_free(data);
+  asset->textureID = textureID;
+  asset->size = header->dataSize;
+  close_asset_file(&asset->file);
 
-  return glContext.textureID;
+  return true;
 }
 
+void unload_texture_asset(Asset* asset)
+{
+  gl_delete_texture(asset->textureID);
+}
+
+/*
+* Loads the Atlas if it isn't resident, or keeps it from being evicted
+*/
+void use_texture_atlas(int atlasIdx)
+{
+  SM_ASSERT(atlasIdx >= 0 && atlasIdx < ATLAS_COUNT, "Unknown AtlasID: %d", atlasIdx);
+
+  AtlasSlot* slot = &atlasResidency.atlases[atlasIdx];
+  slot->lastUsedFrame = atlasResidency.frameIdx;
+  if(slot->handle == INVALID_ASSET_HANDLE || 
+     get_asset_state(slot->handle) == ASSET_STATE_UNLOADED)
+  {
+    slot->handle = request_asset(ASSET_TYPE_TEXTURE, ATLAS_TEXTURE_PATHS[atlasIdx]);
+    if(slot->reloadOnLoad)
+    {
+      slot->reloadOnLoad = false;
+      reload_asset(slot->handle);
+    }
+  }
+}
+
+/*
+* Every Transform picks it's own Atlas, switching only loads the Atlas ahead of time
+*/
 void switch_texture_atlas(const std::string& atlasName)
 {
-  GLuint atlasID = textureAtlases[atlasName];
-  glActiveTexture(GL_TEXTURE0); // Assuming you use texture unit 0
-  glBindTexture(GL_TEXTURE_2D, atlasID);
+  int* atlasIdx = textureAtlases.find(find_string_id(stringInterner, atlasName.c_str()));
+  if(!atlasIdx)
+  {
+    SM_ERROR("Unknown Texture Atlas: %s", atlasName.c_str());
+    return;
+  }
+  use_texture_atlas(*atlasIdx);
+}
+
+/*
+* Called once per frame, loads the Atlases drawn this frame, binds the resident
+* ones and evicts unused Atlases when over budget. Sprites of an Atlas that is
+* still loading are transparent until it is resident
+*/
+void gl_update_atlas_residency()
+{
+  atlasResidency.frameIdx++;
+
+  int usedAtlases = renderData->usedAtlases;
+  renderData->usedAtlases = 0;
+
+  long long residentSize = 0;
+  for(int atlasIdx = 0; atlasIdx < ATLAS_COUNT; atlasIdx++)
+  {
+    if(usedAtlases & BIT(atlasIdx))
+    {
+      use_texture_atlas(atlasIdx);
+    }
+
+    // Hot Reloads keep the old version bound until the new one is uploaded
+    AssetHandle handle = atlasResidency.atlases[atlasIdx].handle;
+    GLuint textureID = handle != INVALID_ASSET_HANDLE? assetLoader.assets[handle].textureID : 0;
+    residentSize += textureID? assetLoader.assets[handle].size : 0;
+    gl_bind_texture(GL_TEXTURE0 + ATLAS_TEXTURE_UNIT + atlasIdx, 
+                    textureID? textureID : atlasResidency.emptyTextureID);
+  }
+
+  while(residentSize > atlasResidency.vramBudget)
+  {
+    int evictIdx = -1;
+    for(int atlasIdx = 0; atlasIdx < ATLAS_COUNT; atlasIdx++)
+    {
+      AtlasSlot* slot = &atlasResidency.atlases[atlasIdx];
+      if(get_asset(slot->handle) &&
+         atlasResidency.frameIdx - slot->lastUsedFrame >= atlasResidency.evictDelayFrames &&
+         (evictIdx < 0 || slot->lastUsedFrame < atlasResidency.atlases[evictIdx].lastUsedFrame))
+      {
+        evictIdx = atlasIdx;
+      }
+    }
+
+    // Everything resident is in use, the budget is exceeded for now
+    if(evictIdx < 0)
+    {
+      break;
+    }
+
+    AssetHandle handle = atlasResidency.atlases[evictIdx].handle;
+    residentSize -= get_asset(handle)->size;
+    gl_bind_texture(GL_TEXTURE0 + ATLAS_TEXTURE_UNIT + evictIdx, atlasResidency.emptyTextureID);
+    unload_asset(handle);
+  }
+}
+
+/*
+* Only queues the decodes, the Workers run them while the main thread creates the
+* Window and compiles the Shaders. gl_init() uploads them. Asking twice is fine,
+* the Asset Loader hands out the same handles. The other Atlases load when first drawn
+*/
+void gl_request_startup_assets()
+{
+  glContext.startupAssets[0] = request_asset(ASSET_TYPE_TEXTURE, MASTER_TEXTURE_PATH);
+  glContext.startupAssets[1] = request_asset(ASSET_TYPE_FONT, "assets/fonts/AtariClassic-gry3.ttf", 8);
 }
 
-bool gl_init(BumpAllocator* transientStorage)
+bool gl_init(BumpAllocator* transientStorage, BumpAllocator* persistentStorage)
 {
   load_gl_functions();
 
@@ -236,81 +654,116 @@ bool gl_init(BumpAllocator* transientStorage)
   glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
   glEnable(GL_DEBUG_OUTPUT);
 
-  GLuint vertShaderID = gl_create_shader(GL_VERTEX_SHADER, 
-                                         "assets/shaders/quad.vert", transientStorage);
-  GLuint fragShaderID = gl_create_shader(GL_FRAGMENT_SHADER, 
-                                         "assets/shaders/quad.frag", transientStorage);
-  if(!vertShaderID || !fragShaderID)
+  // Lets the driver compile on it's own threads, compile and link only queue the work
+  glContext.parallelShaderCompile = glMaxShaderCompilerThreadsKHR_ptr && 
+                                    gl_has_extension("GL_KHR_parallel_shader_compile");
+  if(glContext.parallelShaderCompile)
+  {
+    // As many threads as the driver wants
+    glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+  }
+
+  // Compiles while the Assets below finish loading
+  ShaderCompile startupCompile = gl_begin_shader_compile();
+  if(!startupCompile.programID)
   {
     SM_ASSERT(false, "Failed to create Shaders")
     return false;
   }
 
-  long long timestampVert = get_timestamp("assets/shaders/quad.vert");
-  long long timestampFrag = get_timestamp("assets/shaders/quad.frag");
-  glContext.shaderTimestamp = max(timestampVert, timestampFrag);
+  glContext.shaderHeaderWatchIdx = watch_file(SHADER_HEADER_PATH);
+  glContext.vertShaderWatchIdx = watch_file("assets/shaders/quad.vert");
+  glContext.fragShaderWatchIdx = watch_file("assets/shaders/quad.frag");
 
-  glContext.programID = glCreateProgram();
-  glAttachShader(glContext.programID, vertShaderID);
-  glAttachShader(glContext.programID, fragShaderID);
-  glLinkProgram(glContext.programID);
+  // This has to be done, otherwise OpenGL will not draw anything
+  GLuint VAO;
+  glGenVertexArrays(1, &VAO);
+  glBindVertexArray(VAO);
 
-  // Validate if program works
+  // Texture and Font Loading on the Workers, see asset_loader.h
+  // Only the master atlas is loaded upon start, see gl_update_atlas_residency()
   {
-    int programSuccess;
-    char programInfoLog[512];
-    glGetProgramiv(glContext.programID, GL_LINK_STATUS, &programSuccess);
+    long long startTime = platform_get_time_ns();
 
-    if(!programSuccess)
+    atlasResidency.vramBudget = ATLAS_VRAM_BUDGET;
+    atlasResidency.evictDelayFrames = ATLAS_EVICT_DELAY_FRAMES;
+    for(int atlasIdx = 0; atlasIdx < ATLAS_COUNT; atlasIdx++)
     {
-      glGetProgramInfoLog(glContext.programID, 512, 0, programInfoLog);
+      atlasResidency.atlases[atlasIdx].handle = INVALID_ASSET_HANDLE;
+      atlasResidency.atlases[atlasIdx].watchIdx = watch_file(ATLAS_TEXTURE_PATHS[atlasIdx]);
+    }
 
-      SM_ASSERT(0, "Failed to link program: %s", programInfoLog);
-      return false;
+    // Usually already decoding since before the Window was created
+    gl_request_startup_assets();
+    AssetHandle* assetHandles = glContext.startupAssets;
+    atlasResidency.atlases[ATLAS_MASTER].handle = assetHandles[0];
+    // Nothing can be drawn without them
+    wait_for_assets(assetHandles, ArraySize(glContext.startupAssets));
+    SM_ASSERT(get_asset(assetHandles[0]), "Failed to load texture: %s", MASTER_TEXTURE_PATH);
+    SM_ASSERT(get_asset(assetHandles[1]), "Failed to load Font");
+
+    // Sprites of Atlases that are still loading sample this
+    {
+      unsigned int transparent = 0;
+      glGenTextures(1, &atlasResidency.emptyTextureID);
+      gl_bind_texture(UPLOAD_TEXTURE_UNIT, atlasResidency.emptyTextureID);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+      glTexImage2D(GL_TEXTURE_2D, 0, GL_SRGB8_ALPHA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, 
+                   &transparent);
     }
-  }
 
-  glDetachShader(glContext.programID, vertShaderID);
-  glDetachShader(glContext.programID, fragShaderID);
-  glDeleteShader(vertShaderID);
-  glDeleteShader(fragShaderID);
+    // Names used by switch_texture_atlas()
+    const char* atlasNames[] = {"master", "enemies", "projectiles"};
+    static_assert(ArraySize(atlasNames) == ATLAS_COUNT, "Every Atlas needs a name");
+    textureAtlases = make_hash_map<unsigned int, int>(persistentStorage, ATLAS_COUNT, 
+                                                      ALLOC_TAG_RENDER);
+    for(int atlasIdx = 0; atlasIdx < ATLAS_COUNT; atlasIdx++)
+    {
+      textureAtlases.insert(intern_string(stringInterner, atlasNames[atlasIdx]), atlasIdx);
+    }
 
-  // This has to be done, otherwise OpenGL will not draw anything
-  GLuint VAO;
-  glGenVertexArrays(1, &VAO);
-  glBindVertexArray(VAO);
+    gl_update_atlas_residency();
 
-  // Texture Loading using STBI.
-  // The last atlas in this list will be activated upon start
-  textureAtlases["enemies"] = load_texture_with_stbi(ENEMIES_MASTER_TEXTURE_PATH);
-  textureAtlases["projectiles"] = load_texture_with_stbi(PROJECTILES_MASTER_TEXTURE_PATH);
-  textureAtlases["master"] = load_texture_with_stbi(MASTER_TEXTURE_PATH);
+    SM_TRACE("Waited %.2fms for the master Texture Atlas and Font", 
+             (double)(platform_get_time_ns() - startTime) / 1000000.0);
+  }
 
-  // Load Font
+  // Nothing can be drawn without them, there are no old Shaders to fall back to
+  glContext.programID = gl_finish_shader_compile(&startupCompile);
+  if(!glContext.programID)
   {
-    load_font("assets/fonts/AtariClassic-gry3.ttf", 8);
+    SM_ASSERT(false, "Failed to create Shaders")
+    return false;
   }
 
-  // Transform Storage Buffer
+  // Transform Storage Buffer, Game and UI Transforms are uploaded back to back
   {
+    int maxTransforms = renderData->transforms.maxElements + renderData->uiTransforms.maxElements;
     glGenBuffers(1, &glContext.transformSBOID);
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, glContext.transformSBOID);
-    glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(Transform) * renderData->transforms.maxElements,
-                 renderData->transforms.elements, GL_DYNAMIC_DRAW);
+    gl_bind_buffer_base(GL_SHADER_STORAGE_BUFFER, 0, glContext.transformSBOID);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(Transform) * maxTransforms,
+                 nullptr, GL_DYNAMIC_DRAW);
   }
 
-  // Materials Storage Buffer
+  // Materials Storage Buffer, binding = 1, see quad.frag
   {
     glGenBuffers(1, &glContext.materialSBOID);
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, glContext.materialSBOID);
+    gl_bind_buffer_base(GL_SHADER_STORAGE_BUFFER, 1, glContext.materialSBOID);
     glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(Material) * renderData->materials.maxElements,
                  renderData->materials.elements, GL_DYNAMIC_DRAW);
   }
 
+  // Camera Uniform Buffer, binding = 0, see quad.vert
+  {
+    glGenBuffers(1, &glContext.cameraUBOID);
+    gl_bind_buffer_base(GL_UNIFORM_BUFFER, 0, glContext.cameraUBOID);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(Camera) * MAX_CAMERAS, nullptr, GL_DYNAMIC_DRAW);
+  }
+
   // Uniforms
   {
     glContext.screenSizeID = glGetUniformLocation(glContext.programID, "screenSize");
-    glContext.orthoProjectionID = glGetUniformLocation(glContext.programID, "orthoProjection");
   }
   
   // sRGB output (even if input texture is non-sRGB -> don't rely on texture used)
@@ -324,148 +777,137 @@ bool gl_init(BumpAllocator* transientStorage)
   glEnable(GL_DEPTH_TEST);
   glDepthFunc(GL_GREATER);
 
+  // Every Camera clips to it's own view, see quad.vert
+  glEnable(GL_CLIP_DISTANCE0);
+  glEnable(GL_CLIP_DISTANCE1);
+  glEnable(GL_CLIP_DISTANCE2);
+  glEnable(GL_CLIP_DISTANCE3);
+
   // Use Program
-  glUseProgram(glContext.programID);
+  gl_use_program(glContext.programID);
 
   return true;
 }
 
 void gl_render(BumpAllocator* transientStorage)
 {
-  // Texture Hot Reloading
-  {
-    long long currentTimestamp = get_timestamp(MASTER_TEXTURE_PATH);
+  gl_update_atlas_residency();
 
-    if(currentTimestamp > glContext.textureTimestamp)
-    {    
-      glActiveTexture(GL_TEXTURE0);
-      int width, height, nChannels;
-      char* data = (char*)stbi_load(MASTER_TEXTURE_PATH, &width, &height, &nChannels, 4);
-      if(data)
+  // Texture Hot Reloading, the Workers cook and decode the changed PNG,
+  // the upload replaces the pixels of the Texture, see finalize_texture_asset()
+  for(int atlasIdx = 0; atlasIdx < ATLAS_COUNT; atlasIdx++)
+  {
+    AtlasSlot* slot = &atlasResidency.atlases[atlasIdx];
+    if(file_changed(slot->watchIdx))
+    {
+      if(slot->handle == INVALID_ASSET_HANDLE)
+      {
+        slot->reloadOnLoad = true;
+      }
+      else
       {
-        glContext.textureTimestamp = currentTimestamp;
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_SRGB8_ALPHA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-        stbi_image_free(data);
+        reload_asset(slot->handle);
       }
     }
   }
 
   // Shader Hot Reloading
   {
-    long long timestampVert = get_timestamp("assets/shaders/quad.vert");
-    long long timestampFrag = get_timestamp("assets/shaders/quad.frag");
+    // All of them are checked, so every change is consumed
+    bool headerChanged = file_changed(glContext.shaderHeaderWatchIdx);
+    bool vertChanged = file_changed(glContext.vertShaderWatchIdx);
+    bool fragChanged = file_changed(glContext.fragShaderWatchIdx);
     
-    if(timestampVert > glContext.shaderTimestamp ||
-       timestampFrag > glContext.shaderTimestamp)
+    if(headerChanged || vertChanged || fragChanged)
     {
-      GLuint vertShaderID = gl_create_shader(GL_VERTEX_SHADER, 
-                                              "assets/shaders/quad.vert", transientStorage);
-      GLuint fragShaderID = gl_create_shader(GL_FRAGMENT_SHADER, 
-                                              "assets/shaders/quad.frag", transientStorage);
-      if(!vertShaderID || !fragShaderID)
-      {
-        SM_ASSERT(false, "Failed to create Shaders")
-        return;
-      }
-      GLuint programID = glCreateProgram();
-      glAttachShader(programID, vertShaderID);
-      glAttachShader(programID, fragShaderID);
-      glLinkProgram(programID);
-
-      glDetachShader(programID, vertShaderID);
-      glDetachShader(programID, fragShaderID);
-      glDeleteShader(vertShaderID);
-      glDeleteShader(fragShaderID);
+      // The newest change wins, an older compile in flight is thrown away
+      gl_cancel_shader_compile(&glContext.shaderCompile);
+      glContext.shaderCompile = gl_begin_shader_compile(true);
+    }
 
-      // Validate if program works
+    // Only polled, the frame never waits for the driver
+    if(glContext.shaderCompile.programID && gl_shader_compile_done(&glContext.shaderCompile))
+    {
+      GLuint programID = gl_finish_shader_compile(&glContext.shaderCompile);
+      if(programID)
       {
-        int programSuccess;
-        char programInfoLog[512];
-        glGetProgramiv(programID, GL_LINK_STATUS, &programSuccess);
-
-        if(!programSuccess)
-        {
-          glGetProgramInfoLog(programID, 512, 0, programInfoLog);
+        gl_delete_program(glContext.programID);
+        glContext.programID = programID;
+        gl_use_program(programID);
 
-          SM_ASSERT(0, "Failed to link program: %s", programInfoLog);
-          return;
-        }
+        // Uniform locations can change between programs
+        glContext.screenSizeID = glGetUniformLocation(programID, "screenSize");
+      }
+      else
+      {
+        SM_ERROR("Shader Hot Reload failed, keeping the old Shaders");
       }
-
-      glDeleteProgram(glContext.programID);
-      glContext.programID = programID;
-      glUseProgram(programID);
-
-      glContext.shaderTimestamp = max(timestampVert, timestampFrag);
     }
   }
 
   glClearColor(119.0f / 255.0f, 33.0f / 255.0f, 111.0f / 255.0f, 1.0f);
   glClearDepth(0.0f);
   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-  glViewport(0, 0, input->screenSize.x, input->screenSize.y);
+  gl_viewport(0, 0, input->screenSize.x, input->screenSize.y);
 
   // Copy screen size to the GPU
   {
     Vec2 screenSize = {(float)input->screenSize.x, (float)input->screenSize.y};
-    glUniform2fv(glContext.screenSizeID, 1, &screenSize.x);
+    gl_uniform_2fv(glContext.screenSizeID, &screenSize.x);
   }
 
   // Copy Materials to the GPU
   {
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, glContext.materialSBOID);
-    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, 
+    gl_bind_buffer_base(GL_SHADER_STORAGE_BUFFER, 1, glContext.materialSBOID);
+    gl_buffer_sub_data(GL_SHADER_STORAGE_BUFFER, 0, 
                     sizeof(Material) * renderData->materials.count,
                     renderData->materials.elements);
     renderData->materials.clear();
   }
 
-  // Bind back the Transform Buffer
-  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, glContext.transformSBOID);
-
-  // Game Pass
+  // Copy Cameras to the GPU
   {
-    // Game Orthographic Projection
+    Camera cameras[MAX_CAMERAS] = {};
+    for(int cameraIdx = 0; cameraIdx < MAX_CAMERAS; cameraIdx++)
     {
-      OrthographicCamera2D camera = renderData->gameCamera;
-      Mat4 orthoProjection = orthographic_projection(camera.position.x - camera.dimensions.x / 2.0f, 
-                                                    camera.position.x + camera.dimensions.x / 2.0f, 
-                                                    camera.position.y - camera.dimensions.y / 2.0f, 
-                                                    camera.position.y + camera.dimensions.y / 2.0f);
-      glUniformMatrix4fv(glContext.orthoProjectionID, 1, GL_FALSE, &orthoProjection.ax);
-    }
-
-    // Copy transforms to the GPU
-    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(Transform) * renderData->transforms.count,
-                    renderData->transforms.elements);
+      OrthographicCamera2D camera = renderData->cameras[cameraIdx];
+      if(!camera.dimensions)
+      {
+        // Unused Camera
+        continue;
+      }
 
-    glDrawArraysInstanced(GL_TRIANGLES, 0, 6, renderData->transforms.count);
+      Rect viewport = get_camera_viewport(camera);
+      cameras[cameraIdx].viewProjection = get_camera_projection(camera);
+      cameras[cameraIdx].viewport = {viewport.pos.x, viewport.pos.y, 
+                                     viewport.size.x, viewport.size.y};
+    }
 
-    // Reset for next Frame
-    renderData->transforms.count = 0;
+    gl_bind_buffer(GL_UNIFORM_BUFFER, glContext.cameraUBOID);
+    gl_buffer_sub_data(GL_UNIFORM_BUFFER, 0, sizeof(cameras), cameras);
   }
 
-  // UI Pass
+  // Game and UI Pass, every Transform picks it's Camera, so all Views are one draw
   {
-    // UI Orthographic Projection
-    {
-      OrthographicCamera2D camera = renderData->uiCamera;
-      Mat4 orthoProjection = orthographic_projection(camera.position.x - camera.dimensions.x / 2.0f, 
-                                                    camera.position.x + camera.dimensions.x / 2.0f, 
-                                                    camera.position.y - camera.dimensions.y / 2.0f, 
-                                                    camera.position.y + camera.dimensions.y / 2.0f);
-      glUniformMatrix4fv(glContext.orthoProjectionID, 1, GL_FALSE, &orthoProjection.ax);
-    }
+    int gameCount = renderData->transforms.count;
+    int uiCount = renderData->uiTransforms.count;
 
-    // Copy transforms to the GPU
-    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(Transform) * renderData->uiTransforms.count,
-                    renderData->uiTransforms.elements);
+    // Copy transforms to the GPU, UI after Game, same as the draw order before
+    gl_bind_buffer_base(GL_SHADER_STORAGE_BUFFER, 0, glContext.transformSBOID);
+    gl_buffer_sub_data(GL_SHADER_STORAGE_BUFFER, 0, sizeof(Transform) * gameCount,
+                       renderData->transforms.elements);
+    gl_buffer_sub_data(GL_SHADER_STORAGE_BUFFER, sizeof(Transform) * gameCount, 
+                       sizeof(Transform) * uiCount, renderData->uiTransforms.elements);
 
-    glDrawArraysInstanced(GL_TRIANGLES, 0, 6, renderData->uiTransforms.count);
+    gl_draw_arrays_instanced(GL_TRIANGLES, 0, 6, gameCount + uiCount);
 
     // Reset for next Frame
+    renderData->transforms.count = 0;
     renderData->uiTransforms.count = 0;
   }
+
+  // Expose the GL calls of this frame
+  renderData->stats = glState.frameStats;
 }
 
 
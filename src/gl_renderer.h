@@ -1,6 +1,7 @@
 #pragma once
 
 #include "glcorearb.h"
+#include "render_interface.h"
 
 // #############################################################################
 //                           OpenGL Function Pointers
@@ -59,6 +60,9 @@ static PFNGLDELETESHADERPROC glDeleteShader_ptr;
 static PFNGLDRAWELEMENTSINSTANCEDPROC glDrawElementsInstanced_ptr;
 static PFNGLGENERATEMIPMAPPROC glGenerateMipmap_ptr;
 static PFNGLDEBUGMESSAGECALLBACKPROC glDebugMessageCallback_ptr;
+static PFNGLGETSTRINGIPROC glGetStringi_ptr;
+// GL_KHR_parallel_shader_compile, nullptr if not supported
+static PFNGLMAXSHADERCOMPILERTHREADSKHRPROC glMaxShaderCompilerThreadsKHR_ptr;
 
 
 void load_gl_functions()
@@ -117,6 +121,9 @@ void load_gl_functions()
   glDrawElementsInstanced_ptr = (PFNGLDRAWELEMENTSINSTANCEDPROC) platform_load_gl_function("glDrawElementsInstanced");
   glGenerateMipmap_ptr = (PFNGLGENERATEMIPMAPPROC) platform_load_gl_function("glGenerateMipmap");
   glDebugMessageCallback_ptr = (PFNGLDEBUGMESSAGECALLBACKPROC)platform_load_gl_function("glDebugMessageCallback");
+  glGetStringi_ptr = (PFNGLGETSTRINGIPROC)platform_load_gl_function("glGetStringi");
+  glMaxShaderCompilerThreadsKHR_ptr = 
+    (PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)platform_load_gl_function("glMaxShaderCompilerThreadsKHR");
 }
 
 // #############################################################################
@@ -387,6 +394,16 @@ void glDebugMessageCallback (GLDEBUGPROC callback, const void *userParam)
   glDebugMessageCallback_ptr(callback, userParam);
 }
 
+const GLubyte* glGetStringi(GLenum name, GLuint index)
+{
+  return glGetStringi_ptr(name, index);
+}
+
+void glMaxShaderCompilerThreadsKHR(GLuint count)
+{
+  glMaxShaderCompilerThreadsKHR_ptr(count);
+}
+
 // Loaded by default it seems, but I kept them here, just in case, must be OpenGL 1.0, and static linking
 /*
 static PFNGLTEXIMAGE2DPROC glTexImage2D_ptr;
@@ -498,4 +515,265 @@ void glFrontFace(GLenum mode)
 {
     glFrontFace_ptr(mode);
 }
-*/
\ No newline at end of file
+*/
+
+// #############################################################################
+//                           OpenGL State Cache
+// #############################################################################
+// Tracks what is bound on the GPU, so redundant binds and uploads never 
+// reach the driver. Everything that changes this state has to go through here,
+// otherwise the cache goes stale.
+constexpr int GL_STATE_MAX_TEXTURE_UNITS = 16;
+constexpr int GL_STATE_MAX_BUFFER_BASES = 16;
+constexpr int GL_STATE_MAX_UNIFORMS = 16;
+
+enum GLBufferTarget
+{
+  GL_BUFFER_TARGET_SHADER_STORAGE,
+  GL_BUFFER_TARGET_UNIFORM,
+
+  GL_BUFFER_TARGET_COUNT
+};
+
+struct GLUniformCache
+{
+  GLuint program;
+  GLint location;
+  float values[4];
+};
+
+struct GLStateCache
+{
+  GLuint program;
+  GLenum activeTexture;
+  GLuint textures[GL_STATE_MAX_TEXTURE_UNITS];
+  GLuint buffers[GL_BUFFER_TARGET_COUNT];
+  GLuint bufferBases[GL_BUFFER_TARGET_COUNT][GL_STATE_MAX_BUFFER_BASES];
+  int viewport[4];
+  Array<GLUniformCache, GL_STATE_MAX_UNIFORMS> uniforms;
+
+  RenderStats frameStats;
+};
+
+static GLStateCache glState;
+
+int gl_buffer_target_idx(GLenum target)
+{
+  switch(target)
+  {
+    case GL_SHADER_STORAGE_BUFFER: return GL_BUFFER_TARGET_SHADER_STORAGE;
+    case GL_UNIFORM_BUFFER: return GL_BUFFER_TARGET_UNIFORM;
+  }
+
+  SM_ASSERT(false, "Buffer target not tracked: %d", target);
+  return 0;
+}
+
+void gl_state_begin_frame()
+{
+  glState.frameStats = {};
+}
+
+void gl_use_program(GLuint program)
+{
+  if(glState.program == program)
+  {
+    glState.frameStats.glCallsSkipped++;
+    return;
+  }
+
+  glUseProgram(program);
+  glState.program = program;
+  glState.frameStats.glCallsIssued++;
+  glState.frameStats.programBinds++;
+}
+
+void gl_delete_program(GLuint program)
+{
+  // The ID might be handed out again, uniforms of the old program are stale
+  for(int uniformIdx = 0; uniformIdx < glState.uniforms.count; uniformIdx++)
+  {
+    if(glState.uniforms[uniformIdx].program == program)
+    {
+      glState.uniforms.remove_idx_and_swap(uniformIdx--);
+    }
+  }
+
+  if(glState.program == program)
+  {
+    glState.program = 0;
+  }
+
+  glDeleteProgram(program);
+  glState.frameStats.glCallsIssued++;
+}
+
+void gl_active_texture(GLenum textureUnit)
+{
+  if(glState.activeTexture == textureUnit)
+  {
+    return;
+  }
+
+  glActiveTexture(textureUnit);
+  glState.activeTexture = textureUnit;
+  glState.frameStats.glCallsIssued++;
+}
+
+// Textures are always GL_TEXTURE_2D for now
+void gl_bind_texture(GLenum textureUnit, GLuint texture)
+{
+  int unitIdx = textureUnit - GL_TEXTURE0;
+  SM_ASSERT(unitIdx >= 0 && unitIdx < GL_STATE_MAX_TEXTURE_UNITS, 
+            "Texture unit not tracked: %d", unitIdx);
+
+  if(glState.textures[unitIdx] == texture)
+  {
+    glState.frameStats.glCallsSkipped++;
+    return;
+  }
+
+  gl_active_texture(textureUnit);
+  glBindTexture(GL_TEXTURE_2D, texture);
+  glState.textures[unitIdx] = texture;
+  glState.frameStats.glCallsIssued++;
+  glState.frameStats.textureBinds++;
+}
+
+void gl_delete_texture(GLuint texture)
+{
+  // Deleting unbinds the texture, the ID might be handed out again
+  for(int unitIdx = 0; unitIdx < GL_STATE_MAX_TEXTURE_UNITS; unitIdx++)
+  {
+    if(glState.textures[unitIdx] == texture)
+    {
+      glState.textures[unitIdx] = 0;
+    }
+  }
+
+  glDeleteTextures(1, &texture);
+  glState.frameStats.glCallsIssued++;
+}
+
+void gl_bind_buffer(GLenum target, GLuint buffer)
+{
+  int targetIdx = gl_buffer_target_idx(target);
+  if(glState.buffers[targetIdx] == buffer)
+  {
+    glState.frameStats.glCallsSkipped++;
+    return;
+  }
+
+  glBindBuffer(target, buffer);
+  glState.buffers[targetIdx] = buffer;
+  glState.frameStats.glCallsIssued++;
+  glState.frameStats.bufferBinds++;
+}
+
+void gl_bind_buffer_base(GLenum target, GLuint index, GLuint buffer)
+{
+  SM_ASSERT(index < GL_STATE_MAX_BUFFER_BASES, "Buffer base not tracked: %d", index);
+
+  int targetIdx = gl_buffer_target_idx(target);
+  if(glState.bufferBases[targetIdx][index] == buffer)
+  {
+    // glBindBufferBase also binds to the generic binding point, 
+    // glBufferSubData() might rely on that
+    gl_bind_buffer(target, buffer);
+    glState.frameStats.glCallsSkipped++;
+    return;
+  }
+
+  glBindBufferBase(target, index, buffer);
+  glState.bufferBases[targetIdx][index] = buffer;
+  glState.buffers[targetIdx] = buffer;
+  glState.frameStats.glCallsIssued++;
+  glState.frameStats.bufferBinds++;
+}
+
+void gl_buffer_sub_data(GLenum target, GLintptr offset, GLsizeiptr size, const void* data)
+{
+  if(!size)
+  {
+    glState.frameStats.glCallsSkipped++;
+    return;
+  }
+
+  glBufferSubData(target, offset, size, data);
+  glState.frameStats.glCallsIssued++;
+  glState.frameStats.bufferUploads++;
+}
+
+void gl_viewport(int x, int y, int width, int height)
+{
+  if(glState.viewport[0] == x && glState.viewport[1] == y &&
+     glState.viewport[2] == width && glState.viewport[3] == height)
+  {
+    glState.frameStats.glCallsSkipped++;
+    return;
+  }
+
+  glViewport(x, y, width, height);
+  glState.viewport[0] = x;
+  glState.viewport[1] = y;
+  glState.viewport[2] = width;
+  glState.viewport[3] = height;
+  glState.frameStats.glCallsIssued++;
+  glState.frameStats.viewportChanges++;
+}
+
+// Uniforms belong to the program, so the cache is per program and location
+void gl_uniform_2fv(GLint location, const GLfloat* value)
+{
+  SM_ASSERT(glState.program, "No program in use!");
+
+  GLUniformCache* uniform = nullptr;
+  for(int uniformIdx = 0; uniformIdx < glState.uniforms.count; uniformIdx++)
+  {
+    GLUniformCache& cachedUniform = glState.uniforms[uniformIdx];
+    if(cachedUniform.program == glState.program && cachedUniform.location == location)
+    {
+      uniform = &cachedUniform;
+      break;
+    }
+  }
+
+  if(uniform && 
+     uniform->values[0] == value[0] && 
+     uniform->values[1] == value[1])
+  {
+    glState.frameStats.glCallsSkipped++;
+    return;
+  }
+
+  if(!uniform)
+  {
+    if(glState.uniforms.is_full())
+    {
+      // Programs were reloaded a bunch of times, drop the stale ones
+      glState.uniforms.clear();
+    }
+
+    int uniformIdx = glState.uniforms.add({glState.program, location});
+    uniform = &glState.uniforms[uniformIdx];
+  }
+
+  glUniform2fv(location, 1, value);
+  uniform->values[0] = value[0];
+  uniform->values[1] = value[1];
+  glState.frameStats.glCallsIssued++;
+  glState.frameStats.uniformUploads++;
+}
+
+void gl_draw_arrays_instanced(GLenum mode, GLint first, GLsizei count, GLsizei instanceCount)
+{
+  if(!instanceCount)
+  {
+    glState.frameStats.glCallsSkipped++;
+    return;
+  }
+
+  glDrawArraysInstanced(mode, first, count, instanceCount);
+  glState.frameStats.glCallsIssued++;
+  glState.frameStats.drawCalls++;
+}
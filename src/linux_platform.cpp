@@ -1,10 +1,16 @@
 #include "input.h"
 #include "platform.h"
+#include "file_watcher.h"
 
 #include <X11/Xlib.h>
 #include <GL/glx.h>
 #include <dlfcn.h>  // for loading the so (DLL) file
 #include <unistd.h> // for sleep
+#include <time.h>   // for clock_nanosleep
+#include <errno.h>
+#include <poll.h>
+#include <sys/inotify.h> // for the File Watcher
+#include <sys/eventfd.h>
 
 // #############################################################################
 //                           Linux Defines
@@ -20,6 +26,11 @@ static Display* display;
 static Atom wmDeleteWindow;
 static Window window;
 
+static int inotifyFile = -1;
+// Written to wake up the File Watcher thread when shutting down
+static int fileWatcherWakeFile = -1;
+static std::thread fileWatcherThread;
+
 // #############################################################################
 //                           Platform Implementations
 // #############################################################################
@@ -190,17 +201,23 @@ void platform_set_vsync(bool vSync)
   glXSwapIntervalEXT_ptr(display, window, vSync);
 }
 
+bool platform_link_file(const char* fileName, const char* linkName)
+{
+  // A hard link is only a directory entry, nothing is copied. The compiler
+  // writes a new file for game.so, the link keeps the old contents
+  return link(fileName, linkName) == 0;
+}
+
 void* platform_load_dynamic_library(const char* dll)
 {    
   char path[256] = {};
   sprintf(path, "./%s", dll);
   void* lib = dlopen(path, RTLD_NOW);
-  char *errstr = dlerror(); 
-  if (errstr != NULL) 
+  if(!lib)
   {
-    SM_ASSERT(false, "A dynamic linking error occurred: (%s)\n", errstr);
+    // A reload can catch the library half written, the caller tries again
+    SM_ERROR("Failed to load lib: %s (%s)", dll, dlerror());
   }
-  SM_ASSERT(lib, "Failed to load lib: %s", dll);
 
   return lib;
 }
@@ -370,7 +387,146 @@ void platform_update_audio(float dt)
   soundState->playingSounds.clear();
 }
 
+bool platform_is_playing_sound_data(char* data)
+{
+  // Nothing plays without Linux Audio
+  return false;
+}
+
 void platform_sleep(unsigned int ms)
 {
-  sleep(ms);
+  // sleep() takes seconds, usleep() microseconds
+  usleep(ms * 1000);
+}
+
+long long platform_get_time_ns()
+{
+  timespec time = {};
+  clock_gettime(CLOCK_MONOTONIC, &time);
+  return (long long)time.tv_sec * 1000000000LL + time.tv_nsec;
+}
+
+void platform_sleep_until(long long timeNs)
+{
+  timespec wakeTime = {};
+  wakeTime.tv_sec = timeNs / 1000000000LL;
+  wakeTime.tv_nsec = timeNs % 1000000000LL;
+
+  // Absolute sleeps don't drift when a signal interrupts us, just go back to sleep
+  while(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wakeTime, nullptr) == EINTR)
+  {
+  }
+}
+
+void linux_file_watcher_thread()
+{
+  alignas(inotify_event) char buffer[4096];
+  int timeoutMs = -1;
+  while(true)
+  {
+    pollfd pollFiles[] = 
+    {
+      {inotifyFile, POLLIN},
+      {fileWatcherWakeFile, POLLIN},
+    };
+    if(poll(pollFiles, ArraySize(pollFiles), timeoutMs) < 0 && errno != EINTR)
+    {
+      SM_ERROR("File Watcher failed to poll, errno: %d", errno);
+      break;
+    }
+
+    if(pollFiles[1].revents & POLLIN)
+    {
+      break;
+    }
+
+    long long timeNs = platform_get_time_ns();
+    if(pollFiles[0].revents & POLLIN)
+    {
+      int length = (int)read(inotifyFile, buffer, sizeof(buffer));
+      int watchCount = fileWatcher.watchCount.load(std::memory_order_acquire);
+
+      inotify_event* event = nullptr;
+      for(int offset = 0; offset < length; offset += sizeof(inotify_event) + event->len)
+      {
+        event = (inotify_event*)(buffer + offset);
+        if(!event->len)
+        {
+          continue;
+        }
+
+        for(int watchIdx = 0; watchIdx < watchCount; watchIdx++)
+        {
+          WatchedFile* watchedFile = &fileWatcher.files[watchIdx];
+          if(watchedFile->platformWatchID == event->wd &&
+             strcmp(watchedFile->fileName, event->name) == 0)
+          {
+            file_watcher_touch(watchIdx, timeNs);
+          }
+        }
+      }
+    }
+
+    timeoutMs = file_watcher_publish(timeNs);
+  }
+}
+
+bool platform_init_file_watcher()
+{
+  inotifyFile = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  fileWatcherWakeFile = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if(inotifyFile < 0 || fileWatcherWakeFile < 0)
+  {
+    SM_ERROR("Failed to initialize inotify, errno: %d", errno);
+    return false;
+  }
+
+  fileWatcherThread = std::thread(linux_file_watcher_thread);
+  return true;
+}
+
+void platform_shutdown_file_watcher()
+{
+  if(fileWatcherThread.joinable())
+  {
+    unsigned long long wake = 1;
+    write(fileWatcherWakeFile, &wake, sizeof(wake));
+    fileWatcherThread.join();
+  }
+
+  if(inotifyFile >= 0)
+  {
+    close(inotifyFile);
+    inotifyFile = -1;
+  }
+  if(fileWatcherWakeFile >= 0)
+  {
+    close(fileWatcherWakeFile);
+    fileWatcherWakeFile = -1;
+  }
+}
+
+bool platform_watch_directory(WatchedFile* watchedFile)
+{
+  if(inotifyFile < 0)
+  {
+    return false;
+  }
+
+  // Watching the same directory again returns the same descriptor
+  // Written in place, or moved into place, like build.sh does with game.so
+  int watchDescriptor = inotify_add_watch(inotifyFile, watchedFile->directory, 
+                                          IN_CLOSE_WRITE | IN_MOVED_TO);
+  if(watchDescriptor < 0)
+  {
+    return false;
+  }
+
+  watchedFile->platformWatchID = watchDescriptor;
+  return true;
+}
+
+void platform_wake_file_watcher()
+{
+  // New inotify watches are picked up by the kernel, the thread doesn't care
 }
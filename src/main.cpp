@@ -19,19 +19,27 @@
 #ifdef _WIN32
 #include "win32_platform.cpp"
 const char* gameLibName = "game.dll";
-const char* gameLoadLibName = "game_load.dll";
+const char* gameLoadLibFormat = "game_load_%d.dll";
 #elif defined(__APPLE__)
 #include "mac_platform.cpp"
 const char* gameLibName = "game.so"; // ?????
-const char* gameLoadLibName = "game_load.so";
+const char* gameLoadLibFormat = "game_load_%d.so";
 #else // Linux
 #include "linux_platform.cpp"
 const char* gameLibName = "game.so";
-const char* gameLoadLibName = "game_load.so";
+const char* gameLoadLibFormat = "game_load_%d.so";
 #endif
 
+#include "file_watcher.h"
+
+#include "asset_loader.h"
+
+#include "sound_loader.h"
+
 #include "gl_renderer.cpp"
 
+#include "frame_pacer.h"
+
 // #############################################################################
 //                           Game DLL Stuff
 // #############################################################################
@@ -43,13 +51,41 @@ static update_game_type* update_game_ptr;
 typedef decltype(game_init) game_init_type;
 static game_init_type* game_init_ptr;
 
+// This is the function pointer to game_unload in game.cpp
+typedef decltype(game_unload) game_unload_type;
+
+struct GameDLL
+{
+  void* dll;
+  // Every load gets a unique name, the OS would return the already loaded library
+  char loadPath[64];
+  update_game_type* update_game;
+  game_init_type* game_init;
+  game_unload_type* game_unload;
+};
+
+// Loads a changed Game DLL in the background, the frame only swaps the pointers
+struct GameDLLLoader
+{
+  bool loading;
+  std::thread thread;
+  std::atomic<bool> finished;
+  // Written by the thread before finished is set
+  bool succeeded;
+  GameDLL loadedDLL;
+};
+
+static GameDLL gameDLL;
+static GameDLLLoader gameDLLLoader;
+
 // #############################################################################
 //                           Cross Platform functions
 // #############################################################################
 // Used to get Delta Time
 #include <chrono>
 double get_delta_time();
-void reload_game_dll(BumpAllocator* transientStorage);
+bool reload_game_dll();
+void unload_game_dll();
 
 // #############################################################################
 //                           main Callbacks
@@ -63,87 +99,150 @@ int main()
 {
   // Initialize timestamp
   get_delta_time();
+  long long startupStartNs = platform_get_time_ns();
 
-  BumpAllocator transientStorage = make_bump_allocator(MB(50));
-  BumpAllocator persistentStorage = make_bump_allocator(MB(256));
+  BumpAllocator transientStorage = make_bump_allocator(MB(50), "Transient Storage");
+  BumpAllocator persistentStorage = make_bump_allocator(MB(256), "Persistent Storage");
 
-  input = (Input*)bump_alloc(&persistentStorage, sizeof(Input));
+  input = (Input*)bump_alloc(&persistentStorage, sizeof(Input), ALLOC_TAG_GAME);
   if(!input)
   {
     SM_ERROR("Failed to allocate Input");
     return -1;
   }
 
-  renderData = (RenderData*)bump_alloc(&persistentStorage, sizeof(RenderData));
+  renderData = (RenderData*)bump_alloc(&persistentStorage, sizeof(RenderData), ALLOC_TAG_RENDER);
   if(!renderData)
   {
     SM_ERROR("Failed to allocate RenderData");
     return -1;
   }
 
-  gameState = (GameState*)bump_alloc(&persistentStorage, sizeof(GameState));
+  gameState = (GameState*)bump_alloc(&persistentStorage, sizeof(GameState), ALLOC_TAG_GAME);
   if(!gameState)
   {
     SM_ERROR("Failed to allocate GameState");
     return -1;
   }
 
-  uiState = (UIState*)bump_alloc(&persistentStorage, sizeof(UIState));
+  uiState = (UIState*)bump_alloc(&persistentStorage, sizeof(UIState), ALLOC_TAG_UI);
   if(!uiState)
   {
     SM_ERROR("Failed to allocate UIState")
     return -1;
   }
 
-  soundState = (SoundState*)bump_alloc(&persistentStorage, sizeof(SoundState));
+  soundState = (SoundState*)bump_alloc(&persistentStorage, sizeof(SoundState), ALLOC_TAG_SOUND);
   if(!soundState)
   {
     SM_ERROR("Failed to allocate SoundState");
     return -1;
   }
-  soundState->transientStorage = &transientStorage;
-  soundState->allocatedsoundsBuffer = bump_alloc(&persistentStorage, SOUNDS_BUFFER_SIZE);
-  if(!soundState->allocatedsoundsBuffer)
+  soundState->soundLookup = make_hash_map<unsigned int, int>(&persistentStorage, 
+                                                            MAX_CONCURRENT_SOUNDS,
+                                                            ALLOC_TAG_SOUND);
+
+  stringInterner = (StringInterner*)bump_alloc(&persistentStorage, sizeof(StringInterner));
+  if(!stringInterner)
   {
-    SM_ERROR("Failed to allocated Sounds Buffer");
+    SM_ERROR("Failed to allocate StringInterner");
     return -1;
   }
+  *stringInterner = make_string_interner(&persistentStorage, MAX_INTERNED_STRINGS, 
+                                         MAX_INTERNED_CHARS);
+
+  // Formatting and printing moves to it's own thread, the Game library still logs directly
+  log_init();
+
+  // The main thread is Worker 0, all other cores get a Worker thread
+  job_system_init();
+
+  // Assets are read out of the Asset Pack, everything that isn't packed is loaded from assets/
+  if(!load_asset_pack(ASSET_PACK_PATH))
+  {
+    SM_TRACE("No Asset Pack, loading loose files");
+  }
+
+  // The Atlases and the Font decode on the Workers while the Window is created
+  gl_request_startup_assets();
+
+  // Hot Reloading only looks at files the OS reported as changed
+  if(!platform_init_file_watcher())
+  {
+    SM_ERROR("Failed to start the File Watcher, Hot Reloading is disabled");
+  }
 
   platform_create_window(1280, 720, "Schnitzel Motor");
   platform_fill_keycode_lookup_table();
+  FramePacer framePacer = make_frame_pacer(TARGET_FRAMES_PER_SECOND);
+  // Vsync decides when to present, the pacer only starts the frame late
   platform_set_vsync(true);
   if(!platform_init_audio())
   {
     SM_ERROR("Failed to initialize Audio");
+    platform_shutdown_file_watcher();
+    job_system_shutdown();
+    log_shutdown();
     return -1;
   }
 
-  gl_init(&transientStorage);
+  gl_init(&transientStorage, &persistentStorage);
 
-  bool initialize_game = true;
   while(running)
   {
-    float dt = get_delta_time();
+    frame_pacer_wait(&framePacer);
 
-    reload_game_dll(&transientStorage);
+    float dt = get_delta_time();
 
-    if (initialize_game)
+    // A new library has fresh globals, it has to be initialized again
+    if(reload_game_dll())
     {
       game_init(switch_atlas_callback);
-      initialize_game = false;
     }
 
     // Update
     platform_update_window();
-    update_game(gameState, renderData, input, soundState, uiState, dt);
+
+    // Memory Report on demand, before the Game consumes the Input
+    if(input->keys[KEY_F9].justPressed)
+    {
+      bump_allocator_dump(&persistentStorage);
+      bump_allocator_dump(&transientStorage);
+    }
+
+    // The Stats cover the whole frame, Asset uploads in update_asset_loader() included
+    gl_state_begin_frame();
+
+    update_game(gameState, renderData, input, soundState, uiState, stringInterner, dt);
+    update_sounds();
+    update_asset_loader();
     gl_render(&transientStorage);
     platform_update_audio(dt);
 
+    frame_pacer_begin_present(&framePacer);
     platform_swap_buffers();
+    frame_pacer_end_frame(&framePacer);
 
-    transientStorage.used = 0;
+    if(startupStartNs)
+    {
+      SM_TRACE("First Frame after %.2fms", 
+               (double)(platform_get_time_ns() - startupStartNs) / 1000000.0);
+      startupStartNs = 0;
+    }
+
+    bump_allocator_reset(&transientStorage);
   }
 
+  unload_game_dll();
+  asset_loader_shutdown();
+  platform_shutdown_file_watcher();
+  job_system_shutdown();
+
+  bump_allocator_dump(&persistentStorage);
+  bump_allocator_dump(&transientStorage);
+
+  log_shutdown();
+
   return 0;
 }
 
@@ -152,9 +251,11 @@ void update_game(GameState* gameStateIn,
                 Input* inputIn,
                 SoundState* soundStateIn,
                 UIState* uiStateIn,
+                StringInterner* stringInternerIn,
                 float dt)
 {
-  update_game_ptr(gameStateIn ,renderDataIn, inputIn, soundStateIn, uiStateIn, dt);
+  update_game_ptr(gameStateIn ,renderDataIn, inputIn, soundStateIn, uiStateIn, 
+                  stringInternerIn, dt);
 }
 
 void game_init(std::function<void(const std::string&)> callback)
@@ -175,41 +276,133 @@ double get_delta_time()
   return delta;
 }
 
-void reload_game_dll(BumpAllocator* transientStorage)
+/*
+* Links the Game DLL under a unique name and loads it from there,
+* runs on the loader thread, except for the very first load
+*/
+bool load_game_dll(GameDLL* loadedDLL, int loadIdx)
 {
-  static void* gameDLL;
-  static long long lastEditTimestampGameDLL;
+  *loadedDLL = {};
+  sprintf(loadedDLL->loadPath, gameLoadLibFormat, loadIdx);
+
+  // Left behind if the last run crashed
+  remove(loadedDLL->loadPath);
+  if(!platform_link_file(gameLibName, loadedDLL->loadPath))
+  {
+    SM_ERROR("Failed to link %s to %s", gameLibName, loadedDLL->loadPath);
+    return false;
+  }
 
-  long long currentTimestampGameDLL = get_timestamp(gameLibName);
-  if(currentTimestampGameDLL > lastEditTimestampGameDLL)
+  loadedDLL->dll = platform_load_dynamic_library(loadedDLL->loadPath);
+  if(!loadedDLL->dll)
   {
-    if(gameDLL)
+    remove(loadedDLL->loadPath);
+    return false;
+  }
+
+  loadedDLL->update_game = 
+    (update_game_type*)platform_load_dynamic_function(loadedDLL->dll, "update_game");
+  loadedDLL->game_init = 
+    (game_init_type*)platform_load_dynamic_function(loadedDLL->dll, "game_init");
+  loadedDLL->game_unload = 
+    (game_unload_type*)platform_load_dynamic_function(loadedDLL->dll, "game_unload");
+
+  return loadedDLL->update_game && loadedDLL->game_init && loadedDLL->game_unload;
+}
+
+void free_game_dll(GameDLL* loadedDLL)
+{
+  if(loadedDLL->dll)
+  {
+    // Always called on the main Thread, where the Game ran
+    if(loadedDLL->game_unload)
     {
-      bool freeResult = platform_free_dynamic_library(gameDLL);
-      SM_ASSERT(freeResult, "Failed to free %s", gameLibName);
-      gameDLL = nullptr;
-      SM_TRACE("Freed %s", gameLibName);
+      loadedDLL->game_unload();
     }
 
-    while(!copy_file(gameLibName, gameLoadLibName, transientStorage))
+    bool freeResult = platform_free_dynamic_library(loadedDLL->dll);
+    SM_ASSERT(freeResult, "Failed to free %s", loadedDLL->loadPath);
+    // Kept until now, so debuggers find the symbols
+    remove(loadedDLL->loadPath);
+  }
+
+  *loadedDLL = {};
+}
+
+void use_game_dll(GameDLL* loadedDLL)
+{
+  gameDLL = *loadedDLL;
+  update_game_ptr = gameDLL.update_game;
+  game_init_ptr = gameDLL.game_init;
+  SM_TRACE("Loaded %s from %s", gameLibName, gameDLL.loadPath);
+}
+
+/*
+* Returns true when a new Game DLL is in use, call this at the frame boundary,
+* the old library is freed here, nothing of it can be running
+*/
+bool reload_game_dll()
+{
+  static int gameDLLWatchIdx = -1;
+  static int loadCount;
+
+  // There is nothing to run without the first load, so it blocks
+  if(!gameDLL.dll)
+  {
+    // Watched before loading, so a build finishing during it isn't missed
+    gameDLLWatchIdx = watch_file(gameLibName);
+
+    GameDLL loadedDLL;
+    while(!load_game_dll(&loadedDLL, loadCount++))
     {
+      free_game_dll(&loadedDLL);
       platform_sleep(10);
     }
-    SM_TRACE("Copied %s into %s", gameLibName, gameLoadLibName);
+    use_game_dll(&loadedDLL);
+    return true;
+  }
 
-    gameDLL = platform_load_dynamic_library(gameLoadLibName);
-    SM_ASSERT(gameDLL, "Failed to load %s", gameLoadLibName);
+  // Changes during a load wait in the File Watcher until the load is done
+  if(!gameDLLLoader.loading && file_changed(gameDLLWatchIdx))
+  {
+    int loadIdx = loadCount++;
+    gameDLLLoader.loading = true;
+    gameDLLLoader.finished = false;
+    gameDLLLoader.thread = std::thread([loadIdx]()
+    {
+      gameDLLLoader.succeeded = load_game_dll(&gameDLLLoader.loadedDLL, loadIdx);
+      gameDLLLoader.finished.store(true, std::memory_order_release);
+    });
+  }
 
-    update_game_ptr = (update_game_type*)platform_load_dynamic_function(gameDLL, "update_game");
-    SM_ASSERT(update_game_ptr, "Failed to load update_game function");
-    lastEditTimestampGameDLL = currentTimestampGameDLL;
+  if(gameDLLLoader.loading && gameDLLLoader.finished.load(std::memory_order_acquire))
+  {
+    gameDLLLoader.thread.join();
+    gameDLLLoader.loading = false;
 
-    game_init_ptr = (game_init_type*)platform_load_dynamic_function(gameDLL, "game_init");
-    SM_ASSERT(game_init_ptr, "Failed to load game_init function");
-    lastEditTimestampGameDLL = currentTimestampGameDLL;
-  }
-}
+    if(!gameDLLLoader.succeeded)
+    {
+      SM_ERROR("Failed to reload %s, keeping the old one", gameLibName);
+      free_game_dll(&gameDLLLoader.loadedDLL);
+      return false;
+    }
 
+    free_game_dll(&gameDLL);
+    use_game_dll(&gameDLLLoader.loadedDLL);
+    return true;
+  }
 
+  return false;
+}
 
+void unload_game_dll()
+{
+  if(gameDLLLoader.loading)
+  {
+    gameDLLLoader.thread.join();
+    gameDLLLoader.loading = false;
+    free_game_dll(&gameDLLLoader.loadedDLL);
+  }
 
+  free_game_dll(&gameDLL);
+}
@@ -10,6 +10,8 @@ static KeyCodeID KeyCodeLookupTable[KEY_COUNT];
 // #############################################################################
 //                           Platform Functions
 // #############################################################################
+struct WatchedFile; // See file_watcher.h
+
 bool platform_create_window(int width, int height, char* title);
 void platform_update_window();
 void* platform_load_gl_function(char* funName);
@@ -18,7 +20,15 @@ void platform_set_vsync(bool vSync);
 void* platform_load_dynamic_library(const char* dll);
 void* platform_load_dynamic_function(void* dll, const char* funName);
 bool platform_free_dynamic_library(void* dll);
+bool platform_link_file(const char* fileName, const char* linkName);
 void platform_fill_keycode_lookup_table();
 bool platform_init_audio();
 void platform_update_audio(float dt);
-void platform_sleep(unsigned int ms);
\ No newline at end of file
+bool platform_is_playing_sound_data(char* data);
+void platform_sleep(unsigned int ms);
+long long platform_get_time_ns();
+void platform_sleep_until(long long timeNs);
+bool platform_init_file_watcher();
+void platform_shutdown_file_watcher();
+bool platform_watch_directory(WatchedFile* watchedFile);
+void platform_wake_file_watcher();
@@ -21,11 +21,23 @@ enum Layer
   LAYER_COUNT
 };
 
+enum CameraID
+{
+  CAMERA_GAME,
+  CAMERA_UI,
+
+  // Free slots up to MAX_CAMERAS, e.g. for a Minimap or Split-Screen
+  CAMERA_USER
+};
+
 struct OrthographicCamera2D
 {
   float zoom = 1.0f;
   Vec2 dimensions;
   Vec2 position;
+
+  // Normalized part of the screen, origin is Top Left, empty means fullscreen
+  Rect viewport;
 };
 
 struct DrawData
@@ -34,6 +46,7 @@ struct DrawData
   int animationIdx;
   int renderOptions;
   float layer = 0.0f;
+  int cameraIdx = CAMERA_GAME;
 };
 
 struct TextData
@@ -44,6 +57,22 @@ struct TextData
   float layer = 0.0f;
 };
 
+// Filled by the renderer at the end of every frame, so the game can display it
+struct RenderStats
+{
+  int glCallsIssued;
+  int glCallsSkipped;
+
+  // Issued calls by kind
+  int programBinds;
+  int textureBinds;
+  int bufferBinds;
+  int viewportChanges;
+  int uniformUploads;
+  int bufferUploads;
+  int drawCalls;
+};
+
 struct Glyph
 {
   Vec2 offset;
@@ -54,12 +83,16 @@ struct Glyph
 
 struct RenderData
 {
-  OrthographicCamera2D gameCamera;
-  OrthographicCamera2D uiCamera;
+  OrthographicCamera2D cameras[MAX_CAMERAS];
 
   int fontHeight;
   Glyph glyphs[127];
 
+  RenderStats stats;
+
+  // Bit per AtlasID drawn this frame, the Renderer loads and evicts Atlases by it
+  int usedAtlases;
+
   Array<Material, 1000> materials;
   Array<Transform, 1000> transforms;
   Array<Transform, 1000> uiTransforms;
@@ -73,23 +106,54 @@ static RenderData* renderData;
 // #############################################################################
 //                           Renderer Untility
 // #############################################################################
-IVec2 screen_to_world(IVec2 screenPos)
+// RenderData lives in zeroed memory, so the default values of the
+// Camera are never applied, treat them as "unset"
+Vec2 get_camera_view_size(OrthographicCamera2D camera)
+{
+  float zoom = camera.zoom > 0.0f? camera.zoom : 1.0f;
+  return camera.dimensions / zoom;
+}
+
+Rect get_camera_viewport(OrthographicCamera2D camera)
+{
+  if(!camera.viewport.size)
+  {
+    return {{0.0f, 0.0f}, {1.0f, 1.0f}};
+  }
+
+  return camera.viewport;
+}
+
+Mat4 get_camera_projection(OrthographicCamera2D camera)
+{
+  Vec2 viewSize = get_camera_view_size(camera);
+  return orthographic_projection(camera.position.x - viewSize.x / 2.0f, 
+                                 camera.position.x + viewSize.x / 2.0f, 
+                                 camera.position.y - viewSize.y / 2.0f, 
+                                 camera.position.y + viewSize.y / 2.0f);
+}
+
+IVec2 screen_to_world(IVec2 screenPos, int cameraIdx = CAMERA_GAME)
 {
-  OrthographicCamera2D camera = renderData->gameCamera;
+  OrthographicCamera2D camera = renderData->cameras[cameraIdx];
+  Vec2 viewSize = get_camera_view_size(camera);
+  Rect viewport = get_camera_viewport(camera);
+
+  // Screen position relative to the viewport of the Camera, [0; 1]
+  float viewportX = ((float)screenPos.x / (float)input->screenSize.x - viewport.pos.x) / 
+                    viewport.size.x;
+  float viewportY = ((float)screenPos.y / (float)input->screenSize.y - viewport.pos.y) / 
+                    viewport.size.y;
 
-  int xPos = (float)screenPos.x / 
-             (float)input->screenSize.x * 
-             camera.dimensions.x; // [0; dimensions.x]
+  int xPos = viewportX * viewSize.x; // [0; viewSize.x]
 
-  // Offset using dimensions and position
-  xPos += -camera.dimensions.x / 2.0f + camera.position.x;
+  // Offset using view size and position
+  xPos += -viewSize.x / 2.0f + camera.position.x;
 
-  int yPos = (float)screenPos.y / 
-             (float)input->screenSize.y * 
-             camera.dimensions.y; // [0; dimensions.y]
+  int yPos = viewportY * viewSize.y; // [0; viewSize.y]
 
-  // Offset using dimensions and position
-  yPos += camera.dimensions.y / 2.0f + camera.position.y;
+  // Offset using view size and position
+  yPos += viewSize.y / 2.0f + camera.position.y;
 
   return {xPos, yPos};
 }
@@ -153,8 +217,12 @@ Transform get_transform(SpriteID spriteID, Vec2 pos, Vec2 size = {}, DrawData dr
   // based on the animationIdx
   transform.atlasOffset.x += drawData.animationIdx * sprite.size.x;
   transform.spriteSize = sprite.size;
+  transform.atlasIdx = sprite.atlasIdx;
   transform.renderOptions = drawData.renderOptions;
   transform.layer = drawData.layer;
+  transform.cameraIdx = drawData.cameraIdx;
+
+  renderData->usedAtlases |= BIT(sprite.atlasIdx);
 
   return transform;
 }
@@ -189,12 +257,14 @@ void draw_sprite(SpriteID spriteID, IVec2 pos, DrawData drawData = {})
 // #############################################################################
 void draw_ui_sprite(SpriteID spriteID, Vec2 pos, Vec2 size = {}, DrawData drawData = {})
 {
+  drawData.cameraIdx = CAMERA_UI;
   Transform transform = get_transform(spriteID, pos, size, drawData);
   renderData->uiTransforms.add(transform);
 }
 
 void draw_ui_sprite(SpriteID spriteID, Vec2 pos, DrawData drawData = {})
 {
+  drawData.cameraIdx = CAMERA_UI;
   Transform transform = get_transform(spriteID, pos, {}, drawData);
   renderData->uiTransforms.add(transform);
 }
@@ -235,6 +305,7 @@ void draw_ui_text(char* text, Vec2 pos, TextData textData = {})
     transform.size = vec_2(glyph.size) * textData.fontSize;
     transform.renderOptions = textData.renderOptions | RENDERING_OPTION_FONT;
     transform.layer = textData.layer;
+    transform.cameraIdx = CAMERA_UI;
 
     renderData->uiTransforms.add(transform);
 
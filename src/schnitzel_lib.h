@@ -8,12 +8,46 @@
 // This is to get memset
 #include <string.h>
 
+// This is to get offsetof
+#include <stddef.h>
+
 // Used to get the edit timestamp of files
 #include <sys/stat.h>
 
 // Obvious right?
 #include <math.h>
 
+// Used by the Job System
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+// Used by the Logger to store the arguments of a message
+#include <utility>
+#include <type_traits>
+
+// Used by the SIMD Math, AVX2 only when the compiler targets it (-mavx2),
+// SSE2 is part of every x64 CPU
+#if defined(__AVX2__)
+#define SIMD_AVX2
+#define SIMD_SSE2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#define SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
+// Used to reserve and commit Virtual Memory
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 // #############################################################################
 //                           Constants
 // #############################################################################
@@ -68,8 +102,45 @@ enum TextColor
   TEXT_COLOR_COUNT
 };
 
-template <typename ...Args>
-void _log(char* prefix, char* msg, TextColor textColor, Args... args)
+// Levels below SM_LOG_LEVEL are compiled out, their arguments are not evaluated.
+// Build with -DSM_LOG_LEVEL=LOG_LEVEL_ERROR to only keep Errors
+#define LOG_LEVEL_TRACE 0
+#define LOG_LEVEL_WARN 1
+#define LOG_LEVEL_ERROR 2
+#define LOG_LEVEL_NONE 3
+
+#ifndef SM_LOG_LEVEL
+#define SM_LOG_LEVEL LOG_LEVEL_TRACE
+#endif
+
+constexpr int LOG_MESSAGE_SIZE = 8192;
+// Arguments and copied Strings of a queued message, longer Strings are cut off
+constexpr int LOG_PAYLOAD_SIZE = 480;
+
+typedef int LogFormatFunction(char* buffer, int bufferSize, const char* format, char* payload);
+
+/*
+* A message waiting for the Logger thread. The format and prefix are
+* String literals, so only the pointers are stored. The arguments are
+* copied into the payload, Strings included, the caller's memory might
+* be gone by the time the message gets formatted
+*/
+struct LogMessage
+{
+  LogFormatFunction* formatFunction;
+  const char* prefix;
+  const char* format;
+  TextColor textColor;
+  alignas(16) char payload[LOG_PAYLOAD_SIZE];
+};
+
+// Set by log_init(), until then, and in the Game library, logging is synchronous
+static std::atomic<bool> asyncLoggingEnabled;
+
+bool log_push(LogMessage* message);
+void log_flush();
+
+void log_write(const char* prefix, const char* text, TextColor textColor)
 {
   static char* TextColorTable[TEXT_COLOR_COUNT] = 
   {    
@@ -91,24 +162,198 @@ void _log(char* prefix, char* msg, TextColor textColor, Args... args)
     "\x1b[97m", // TEXT_COLOR_BRIGHT_WHITE
   };
 
-  char formatBuffer[8192] = {};
-  sprintf(formatBuffer, "%s %s %s \033[0m", TextColorTable[textColor], prefix, msg);
+  printf("%s %s %s \033[0m\n", TextColorTable[textColor], prefix, text);
+}
+
+// Strings are stored as an offset into the payload, everything else by value
+template<typename T>
+struct LogArg
+{
+  typedef T Stored;
+};
+
+template<>
+struct LogArg<char*>
+{
+  typedef int Stored;
+};
+
+template<>
+struct LogArg<const char*>
+{
+  typedef int Stored;
+};
+
+template<typename T>
+typename LogArg<T>::Stored log_capture_arg(T arg, char* payload, int* payloadUsed)
+{
+  return arg;
+}
+
+template<>
+int log_capture_arg<const char*>(const char* string, char* payload, int* payloadUsed)
+{
+  if(!string)
+  {
+    return -1;
+  }
+
+  // The last byte always stays 0, Strings that don't fit point at it
+  int length = (int)strlen(string);
+  int spaceLeft = LOG_PAYLOAD_SIZE - 1 - *payloadUsed;
+  length = length < spaceLeft? length : spaceLeft;
+
+  int offset = *payloadUsed;
+  memcpy(payload + offset, string, length);
+  payload[offset + length] = 0;
+  *payloadUsed += length + (length < spaceLeft);
+
+  return offset;
+}
+
+template<>
+int log_capture_arg<char*>(char* string, char* payload, int* payloadUsed)
+{
+  return log_capture_arg<const char*>(string, payload, payloadUsed);
+}
+
+template<typename T>
+T log_restore_arg(typename LogArg<T>::Stored stored, char* payload)
+{
+  return stored;
+}
+
+template<>
+const char* log_restore_arg<const char*>(int offset, char* payload)
+{
+  return offset < 0? "(null)" : payload + offset;
+}
+
+template<>
+char* log_restore_arg<char*>(int offset, char* payload)
+{
+  return offset < 0? "(null)" : payload + offset;
+}
+
+/*
+* Every stored argument gets its own slot at the start of the payload,
+* aligned like its type. The slots are copied one by one with memcpy,
+* that is only allowed for trivially copyable types
+*/
+template<typename ...Stored>
+struct LogPayloadLayout
+{
+  int offsets[sizeof...(Stored) + 1];
+  int size;
+
+  constexpr LogPayloadLayout() : offsets(), size(0)
+  {
+    int sizes[] = {(int)sizeof(Stored)..., 0};
+    int alignments[] = {(int)alignof(Stored)..., 1};
+    for(int argIdx = 0; argIdx < (int)sizeof...(Stored); argIdx++)
+    {
+      size = (size + alignments[argIdx] - 1) & ~(alignments[argIdx] - 1);
+      offsets[argIdx] = size;
+      size += sizes[argIdx];
+    }
+  }
+};
+
+template<typename T>
+void log_store_arg(char* slot, T stored)
+{
+  static_assert(std::is_trivially_copyable<T>::value, "Can't log this type!");
+  memcpy(slot, &stored, sizeof(T));
+}
+
+template<typename T>
+T log_load_arg(char* slot)
+{
+  T stored;
+  memcpy(&stored, slot, sizeof(T));
+  return stored;
+}
+
+template<typename ...Args, size_t ...ArgIndices>
+void log_capture_payload(char* payload, std::index_sequence<ArgIndices...>, Args... args)
+{
+  constexpr LogPayloadLayout<typename LogArg<Args>::Stored...> layout;
+  static_assert(layout.size < LOG_PAYLOAD_SIZE, "Too many arguments to log!");
+
+  // The comma operator evaluates in order, so the Strings end up in order after the slots
+  int payloadUsed = layout.size;
+  (log_store_arg(payload + layout.offsets[ArgIndices], 
+                 log_capture_arg<Args>(args, payload, &payloadUsed)), ...);
+}
+
+template<typename ...Args, size_t ...ArgIndices>
+int log_format_payload(char* buffer, int bufferSize, const char* format, char* payload,
+                       std::index_sequence<ArgIndices...>)
+{
+  constexpr LogPayloadLayout<typename LogArg<Args>::Stored...> layout;
+  return snprintf(buffer, bufferSize, format, 
+                  log_restore_arg<Args>(log_load_arg<typename LogArg<Args>::Stored>(
+                                          payload + layout.offsets[ArgIndices]), payload)...);
+}
+
+/*
+* Runs on the Logger thread, one instance per argument list
+*/
+template<typename ...Args>
+int log_format(char* buffer, int bufferSize, const char* format, char* payload)
+{
+  return log_format_payload<Args...>(buffer, bufferSize, format, payload, 
+                                     std::index_sequence_for<Args...>{});
+}
 
-  char textBuffer[8912] = {};
-  sprintf(textBuffer, formatBuffer, args...);
+template <typename ...Args>
+void _log(char* prefix, char* msg, TextColor textColor, Args... args)
+{
+  if(asyncLoggingEnabled.load(std::memory_order_relaxed))
+  {
+    LogMessage message;
+    message.formatFunction = log_format<Args...>;
+    message.prefix = prefix;
+    message.format = msg;
+    message.textColor = textColor;
+    log_capture_payload(message.payload, std::index_sequence_for<Args...>{}, args...);
+
+    if(log_push(&message))
+    {
+      return;
+    }
+  }
 
-  puts(textBuffer);
+  char textBuffer[LOG_MESSAGE_SIZE];
+  snprintf(textBuffer, sizeof(textBuffer), msg, args...);
+  log_write(prefix, textBuffer, textColor);
 }
 
+#if SM_LOG_LEVEL <= LOG_LEVEL_TRACE
 #define SM_TRACE(msg, ...) _log("TRACE: ", msg, TEXT_COLOR_GREEN, ##__VA_ARGS__);
+#else
+#define SM_TRACE(msg, ...)
+#endif
+
+#if SM_LOG_LEVEL <= LOG_LEVEL_WARN
 #define SM_WARN(msg, ...) _log("WARN: ", msg, TEXT_COLOR_YELLOW, ##__VA_ARGS__);
+#else
+#define SM_WARN(msg, ...)
+#endif
+
+#if SM_LOG_LEVEL <= LOG_LEVEL_ERROR
 #define SM_ERROR(msg, ...) _log("ERROR: ", msg, TEXT_COLOR_RED, ##__VA_ARGS__);
+#else
+#define SM_ERROR(msg, ...)
+#endif
 
+// Queued messages are written before breaking, they might explain the Assert
 #define SM_ASSERT(x, msg, ...)    \
 {                                 \
   if(!(x))                        \
   {                               \
     SM_ERROR(msg, ##__VA_ARGS__); \
+    log_flush();                  \
     DEBUG_BREAK();                \
     SM_ERROR("Assertion HIT!")    \
   }                               \
@@ -145,61 +390,1497 @@ struct Array
     elements[idx] = elements[--count];
   }
 
-  void clear()
+  void clear()
+  {
+    count = 0;
+  }
+
+  bool is_full()
+  {
+    return count == N;
+  }
+};
+
+// #############################################################################
+//                           Pool
+// #############################################################################
+// Lower bits are the slot index, upper bits the generation of the slot
+constexpr int POOL_HANDLE_INDEX_BITS = 16;
+constexpr unsigned int POOL_HANDLE_INDEX_MASK = (1u << POOL_HANDLE_INDEX_BITS) - 1;
+
+// Handles don't dangle, once the element is removed get() returns nullptr.
+// 0 is never a valid Handle, so zeroed memory is "no element"
+struct PoolHandle
+{
+  unsigned int value;
+
+  int index()
+  {
+    return value & POOL_HANDLE_INDEX_MASK;
+  }
+
+  unsigned int generation()
+  {
+    return value >> POOL_HANDLE_INDEX_BITS;
+  }
+
+  operator bool()
+  {
+    return value != 0;
+  }
+};
+
+/*
+* Fixed size Pool, removing doesn't move other elements. Everything is
+* stored inline and works from zeroed memory, so it can live in the
+* persistent storage and survives hot reloading
+*/
+template<typename T, int N>
+struct Pool
+{
+  static_assert(N <= POOL_HANDLE_INDEX_MASK + 1, "Pool too big for PoolHandle");
+
+  static constexpr int maxElements = N;
+  int count = 0;
+  // Slots [0, slotsUsed) have been handed out at least once
+  int slotsUsed = 0;
+  // Free slots are linked through nextFree, stored as index + 1, 0 is the end
+  int freeListHead = 0;
+  int nextFree[N];
+  unsigned short generations[N];
+  bool alive[N];
+  T elements[N];
+
+  PoolHandle add(T element)
+  {
+    SM_ASSERT(count < maxElements, "Pool Full!");
+
+    int idx = 0;
+    if(freeListHead)
+    {
+      idx = freeListHead - 1;
+      freeListHead = nextFree[idx];
+    }
+    else
+    {
+      idx = slotsUsed++;
+    }
+
+    // Generation 0 is reserved for invalid Handles
+    if(!generations[idx])
+    {
+      generations[idx] = 1;
+    }
+
+    alive[idx] = true;
+    elements[idx] = element;
+    count++;
+
+    return get_handle(idx);
+  }
+
+  void remove(PoolHandle handle)
+  {
+    SM_ASSERT(is_valid(handle), "Removing invalid PoolHandle!");
+
+    int idx = handle.index();
+    alive[idx] = false;
+    // Invalidates all Handles to this slot
+    generations[idx]++;
+    nextFree[idx] = freeListHead;
+    freeListHead = idx + 1;
+    count--;
+  }
+
+  bool is_valid(PoolHandle handle)
+  {
+    int idx = handle.index();
+    return handle && idx < slotsUsed && alive[idx] &&
+           generations[idx] == handle.generation();
+  }
+
+  T* get(PoolHandle handle)
+  {
+    return is_valid(handle)? &elements[handle.index()] : nullptr;
+  }
+
+  // Iterate over [0, slotsUsed), nullptr for free slots
+  T* get_at(int idx)
+  {
+    SM_ASSERT(idx >= 0, "idx negative!");
+    SM_ASSERT(idx < slotsUsed, "Idx out of bounds!");
+    return alive[idx]? &elements[idx] : nullptr;
+  }
+
+  PoolHandle get_handle(int idx)
+  {
+    SM_ASSERT(alive[idx], "Slot is free!");
+    return {(unsigned int)generations[idx] << POOL_HANDLE_INDEX_BITS | (unsigned int)idx};
+  }
+
+  void clear()
+  {
+    for(int idx = 0; idx < slotsUsed; idx++)
+    {
+      if(alive[idx])
+      {
+        remove(get_handle(idx));
+      }
+    }
+  }
+
+  bool is_full()
+  {
+    return count == N;
+  }
+};
+
+// #############################################################################
+//                           Bump Allocator
+// #############################################################################
+// Address Space is reserved up front, physical memory is only
+// committed in chunks of this size when the allocator grows into it
+constexpr size_t BUMP_ALLOCATOR_COMMIT_SIZE = KB(64);
+
+// Every allocation is tagged with the System it belongs to,
+// so we know who uses how much of the budgets
+enum AllocTag
+{
+  ALLOC_TAG_UNTAGGED,
+  ALLOC_TAG_RENDER,
+  ALLOC_TAG_SOUND,
+  ALLOC_TAG_GAME,
+  ALLOC_TAG_UI,
+  ALLOC_TAG_IO,
+
+  ALLOC_TAG_COUNT
+};
+
+static const char* ALLOC_TAG_NAMES[ALLOC_TAG_COUNT] =
+{
+  "Untagged",
+  "Render",
+  "Sound",
+  "Game",
+  "UI",
+  "IO",
+};
+
+struct AllocTagStats
+{
+  size_t used;
+  size_t peak;
+};
+
+struct BumpAllocator
+{
+  const char* name;
+  size_t capacity;
+  size_t committed;
+  size_t used;
+  size_t highWaterMark; // Most memory ever used at once
+  size_t frameHighWaterMark; // Since the last reset
+  size_t lastFrameHighWaterMark;
+  AllocTagStats tags[ALLOC_TAG_COUNT];
+  char* memory;
+};
+
+BumpAllocator make_bump_allocator(size_t size, const char* name = "BumpAllocator")
+{
+  BumpAllocator ba = {};
+  ba.name = name;
+
+  // Windows reserves in 64KB granularity, this also keeps commits page aligned
+  size = (size + BUMP_ALLOCATOR_COMMIT_SIZE - 1) & ~(BUMP_ALLOCATOR_COMMIT_SIZE - 1);
+
+#ifdef _WIN32
+  ba.memory = (char*)VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_NOACCESS);
+#else
+  ba.memory = (char*)mmap(nullptr, size, PROT_NONE, 
+                          MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if(ba.memory == MAP_FAILED)
+  {
+    ba.memory = nullptr;
+  }
+#endif
+
+  if(ba.memory)
+  {
+    ba.capacity = size;
+  }
+  else
+  {
+    SM_ASSERT(false, "Failed to reserve Memory!");
+  }
+
+  return ba;
+}
+
+/*
+* Commits physical memory up to at least the given size,
+* freshly committed memory is always 0
+*/
+bool bump_allocator_commit(BumpAllocator* bumpAllocator, size_t size)
+{
+  if(size <= bumpAllocator->committed)
+  {
+    return true;
+  }
+
+  size_t commitEnd = (size + BUMP_ALLOCATOR_COMMIT_SIZE - 1) & ~(BUMP_ALLOCATOR_COMMIT_SIZE - 1);
+  commitEnd = commitEnd < bumpAllocator->capacity? commitEnd : bumpAllocator->capacity;
+
+  char* commitStart = bumpAllocator->memory + bumpAllocator->committed;
+  size_t commitSize = commitEnd - bumpAllocator->committed;
+
+#ifdef _WIN32
+  bool success = VirtualAlloc(commitStart, commitSize, MEM_COMMIT, PAGE_READWRITE);
+#else
+  bool success = mprotect(commitStart, commitSize, PROT_READ | PROT_WRITE) == 0;
+#endif
+
+  if(!success)
+  {
+    SM_ASSERT(false, "Failed to commit Memory!");
+    return false;
+  }
+  bumpAllocator->committed = commitEnd;
+
+  return true;
+}
+
+void bump_allocator_dump(BumpAllocator* bumpAllocator)
+{
+  double mb = (double)MB(1);
+  SM_TRACE("%s: used %.2fMB, peak %.2fMB, last frame peak %.2fMB, committed %.2fMB, capacity %.2fMB",
+           bumpAllocator->name,
+           (double)bumpAllocator->used / mb,
+           (double)bumpAllocator->highWaterMark / mb,
+           (double)bumpAllocator->lastFrameHighWaterMark / mb,
+           (double)bumpAllocator->committed / mb,
+           (double)bumpAllocator->capacity / mb);
+
+  for(int tagIdx = 0; tagIdx < ALLOC_TAG_COUNT; tagIdx++)
+  {
+    AllocTagStats& tag = bumpAllocator->tags[tagIdx];
+    if(tag.peak)
+    {
+      SM_TRACE("  %-10s used %.2fMB, peak %.2fMB", ALLOC_TAG_NAMES[tagIdx],
+               (double)tag.used / mb, (double)tag.peak / mb);
+    }
+  }
+}
+
+char* bump_alloc(BumpAllocator* bumpAllocator, size_t size, AllocTag tag = ALLOC_TAG_UNTAGGED)
+{
+  char* result = nullptr;
+
+  size_t allignedSize = (size + 7) & ~ 7; // This makes sure the first 4 bits are 0 
+  if(bumpAllocator->used + allignedSize <= bumpAllocator->capacity)
+  {
+    if(bump_allocator_commit(bumpAllocator, bumpAllocator->used + allignedSize))
+    {
+      result = bumpAllocator->memory + bumpAllocator->used;
+      bumpAllocator->used += allignedSize;
+      if(bumpAllocator->used > bumpAllocator->highWaterMark)
+      {
+        bumpAllocator->highWaterMark = bumpAllocator->used;
+      }
+      if(bumpAllocator->used > bumpAllocator->frameHighWaterMark)
+      {
+        bumpAllocator->frameHighWaterMark = bumpAllocator->used;
+      }
+
+      AllocTagStats& tagStats = bumpAllocator->tags[tag];
+      tagStats.used += allignedSize;
+      if(tagStats.used > tagStats.peak)
+      {
+        tagStats.peak = tagStats.used;
+      }
+    }
+  }
+  else
+  {
+    // Shows who used up the memory
+    bump_allocator_dump(bumpAllocator);
+    SM_ASSERT(false, "%s is full, requested %zu bytes for %s", 
+              bumpAllocator->name, size, ALLOC_TAG_NAMES[tag]);
+  }
+
+  return result;
+}
+
+/*
+* Frees everything, decommit gives the physical memory back to the
+* OS, the next allocations get fresh zeroed memory
+*/
+void bump_allocator_reset(BumpAllocator* bumpAllocator, bool decommit = false)
+{
+  bumpAllocator->used = 0;
+  bumpAllocator->lastFrameHighWaterMark = bumpAllocator->frameHighWaterMark;
+  bumpAllocator->frameHighWaterMark = 0;
+  for(int tagIdx = 0; tagIdx < ALLOC_TAG_COUNT; tagIdx++)
+  {
+    bumpAllocator->tags[tagIdx].used = 0;
+  }
+
+  if(decommit && bumpAllocator->committed)
+  {
+#ifdef _WIN32
+    VirtualFree(bumpAllocator->memory, bumpAllocator->committed, MEM_DECOMMIT);
+#else
+    madvise(bumpAllocator->memory, bumpAllocator->committed, MADV_DONTNEED);
+    mprotect(bumpAllocator->memory, bumpAllocator->committed, PROT_NONE);
+#endif
+    bumpAllocator->committed = 0;
+  }
+}
+
+/*
+* Gives the reserved Address Space back to the OS, the allocator is zeroed
+*/
+void bump_allocator_release(BumpAllocator* bumpAllocator)
+{
+  if(bumpAllocator->memory)
+  {
+#ifdef _WIN32
+    VirtualFree(bumpAllocator->memory, 0, MEM_RELEASE);
+#else
+    munmap(bumpAllocator->memory, bumpAllocator->capacity);
+#endif
+  }
+
+  *bumpAllocator = {};
+}
+
+// #############################################################################
+//                           Temp Arenas
+// #############################################################################
+// Scratch Arenas only reserve Address Space, see make_bump_allocator
+constexpr size_t SCRATCH_ARENA_SIZE = MB(64);
+
+// Marks the current position of an Arena, everything
+// allocated after begin_temp() is freed by end_temp()
+struct TempArena
+{
+  BumpAllocator* bumpAllocator;
+  size_t used;
+  size_t tagsUsed[ALLOC_TAG_COUNT];
+};
+
+TempArena begin_temp(BumpAllocator* bumpAllocator)
+{
+  TempArena temp = {};
+  temp.bumpAllocator = bumpAllocator;
+  temp.used = bumpAllocator->used;
+  for(int tagIdx = 0; tagIdx < ALLOC_TAG_COUNT; tagIdx++)
+  {
+    temp.tagsUsed[tagIdx] = bumpAllocator->tags[tagIdx].used;
+  }
+  return temp;
+}
+
+void end_temp(TempArena temp)
+{
+  SM_ASSERT(temp.bumpAllocator->used >= temp.used, "Temp Arenas ended out of order");
+  temp.bumpAllocator->used = temp.used;
+  for(int tagIdx = 0; tagIdx < ALLOC_TAG_COUNT; tagIdx++)
+  {
+    temp.bumpAllocator->tags[tagIdx].used = temp.tagsUsed[tagIdx];
+  }
+}
+
+// Calls end_temp() when leaving the scope
+struct TempArenaScope
+{
+  TempArena temp;
+
+  TempArenaScope(TempArena temp) : temp(temp) {}
+  TempArenaScope(BumpAllocator* bumpAllocator) : temp(begin_temp(bumpAllocator)) {}
+  ~TempArenaScope() { end_temp(temp); }
+
+  TempArenaScope(const TempArenaScope&) = delete;
+  TempArenaScope& operator=(const TempArenaScope&) = delete;
+
+  BumpAllocator* arena()
+  {
+    return temp.bumpAllocator;
+  }
+};
+
+// Two per Thread, so a function can use one for Scratch while 
+// it's caller passed the other one in to allocate the result
+static thread_local BumpAllocator scratchArenas[2];
+
+/*
+* Returns a Temp Arena on a Scratch Arena of the calling Thread,
+* pass the Arena the results are allocated in as conflict, so
+* the Scratch memory never overlaps it
+*/
+TempArena get_scratch(BumpAllocator* conflict = nullptr)
+{
+  BumpAllocator* scratch = &scratchArenas[0] == conflict? &scratchArenas[1] : &scratchArenas[0];
+  if(!scratch->memory)
+  {
+    *scratch = make_bump_allocator(SCRATCH_ARENA_SIZE, "Scratch Arena");
+  }
+
+  return begin_temp(scratch);
+}
+
+/*
+* Releases the Scratch Arenas of the calling Thread. Every library has its
+* own copy of them, the Game calls this before it is unloaded, otherwise
+* every Hot Reload would leak their Address Space
+*/
+void release_scratch_arenas()
+{
+  bump_allocator_release(&scratchArenas[0]);
+  bump_allocator_release(&scratchArenas[1]);
+}
+
+// #############################################################################
+//                           Arena Arrays
+// #############################################################################
+// Growable Array inside of an Arena, elements are moved with memcpy, so
+// only use it for plain data. Don't keep it past a reset of the Arena!
+template<typename T>
+struct DynArray
+{
+  BumpAllocator* bumpAllocator;
+  AllocTag tag;
+  int count;
+  int capacity;
+  T* elements;
+
+  T& operator[](int idx)
+  {
+    SM_ASSERT(idx >= 0, "idx negative!");
+    SM_ASSERT(idx < count, "Idx out of bounds!");
+    return elements[idx];
+  }
+
+  void reserve(int newCapacity)
+  {
+    if(newCapacity <= capacity)
+    {
+      return;
+    }
+    SM_ASSERT(bumpAllocator, "DynArray has no Arena, use make_dyn_array()");
+
+    // bump_alloc() rounds up to 8 bytes, so does the end of the elements
+    size_t oldSize = (capacity * sizeof(T) + 7) & ~7;
+    size_t newSize = (newCapacity * sizeof(T) + 7) & ~7;
+
+    // Grow in place if nothing was allocated after us
+    char* end = (char*)elements + oldSize;
+    if(elements && end == bumpAllocator->memory + bumpAllocator->used &&
+       bump_alloc(bumpAllocator, newSize - oldSize, tag))
+    {
+      capacity = newCapacity;
+      return;
+    }
+
+    T* newElements = (T*)bump_alloc(bumpAllocator, newSize, tag);
+    if(newElements)
+    {
+      if(count)
+      {
+        memcpy(newElements, elements, count * sizeof(T));
+      }
+      elements = newElements;
+      capacity = newCapacity;
+    }
+  }
+
+  int add(T element)
+  {
+    if(count == capacity)
+    {
+      reserve(capacity? capacity * 2 : 8);
+    }
+    SM_ASSERT(count < capacity, "DynArray failed to grow!");
+    elements[count] = element;
+    return count++;
+  }
+
+  void remove_idx_and_swap(int idx)
+  {
+    SM_ASSERT(idx >= 0, "idx negative!");
+    SM_ASSERT(idx < count, "idx out of bounds!");
+    elements[idx] = elements[--count];
+  }
+
+  void clear()
+  {
+    count = 0;
+  }
+};
+
+template<typename T>
+DynArray<T> make_dyn_array(BumpAllocator* bumpAllocator, int capacity = 0, 
+                           AllocTag tag = ALLOC_TAG_UNTAGGED)
+{
+  DynArray<T> dynArray = {};
+  dynArray.bumpAllocator = bumpAllocator;
+  dynArray.tag = tag;
+  dynArray.reserve(capacity);
+  return dynArray;
+}
+
+// Keeps the first N elements inline and spills into the Arena once
+// they are used up, works from zeroed memory like Array
+template<typename T, int N>
+struct SmallArray
+{
+  static constexpr int inlineElements = N;
+  int count = 0;
+  T inlineStorage[N];
+  // Arena to spill into, without one this is just an Array<T, N>
+  BumpAllocator* bumpAllocator;
+  DynArray<T> spilled;
+
+  T* data()
+  {
+    return spilled.elements? spilled.elements : inlineStorage;
+  }
+
+  T& operator[](int idx)
+  {
+    SM_ASSERT(idx >= 0, "idx negative!");
+    SM_ASSERT(idx < count, "Idx out of bounds!");
+    return data()[idx];
+  }
+
+  int add(T element)
+  {
+    if(!spilled.elements && count == N)
+    {
+      SM_ASSERT(bumpAllocator, "SmallArray Full and no Arena to spill into!");
+      spilled = make_dyn_array<T>(bumpAllocator, N * 2);
+      memcpy(spilled.elements, inlineStorage, count * sizeof(T));
+      spilled.count = count;
+    }
+
+    if(spilled.elements)
+    {
+      spilled.add(element);
+    }
+    else
+    {
+      inlineStorage[count] = element;
+    }
+    return count++;
+  }
+
+  void remove_idx_and_swap(int idx)
+  {
+    SM_ASSERT(idx >= 0, "idx negative!");
+    SM_ASSERT(idx < count, "idx out of bounds!");
+    T* elements = data();
+    elements[idx] = elements[--count];
+    spilled.count = spilled.elements? count : 0;
+  }
+
+  // Goes back to the inline storage, the spilled memory is freed with the Arena
+  void clear()
+  {
+    count = 0;
+    spilled = {};
+  }
+};
+
+// #############################################################################
+//                           Hash Map
+// #############################################################################
+// Grows once more than 7/8 of the slots are used
+constexpr int HASH_MAP_MAX_LOAD_NUMERATOR = 7;
+constexpr int HASH_MAP_MAX_LOAD_DENOMINATOR = 8;
+
+// The HashMap uses the upper bits of the hash, Fibonacci hashing
+// moves the entropy of similar keys up there
+unsigned long long hash_key(unsigned long long key)
+{
+  return key * 0x9E3779B97F4A7C15ULL;
+}
+
+unsigned long long hash_key(unsigned int key)
+{
+  return hash_key((unsigned long long)key);
+}
+
+unsigned long long hash_string(const char* string)
+{
+  // FNV-1a
+  unsigned long long hash = 0xCBF29CE484222325ULL;
+  while(*string)
+  {
+    hash ^= (unsigned char)*string++;
+    hash *= 0x100000001B3ULL;
+  }
+  return hash;
+}
+
+/*
+* FNV-1a over size bytes, seed chains several blocks into one hash
+*/
+unsigned long long hash_data(const void* data, long long size,
+                             unsigned long long seed = 0xCBF29CE484222325ULL)
+{
+  const unsigned char* bytes = (const unsigned char*)data;
+  unsigned long long hash = seed;
+  for(long long byteIdx = 0; byteIdx < size; byteIdx++)
+  {
+    hash ^= bytes[byteIdx];
+    hash *= 0x100000001B3ULL;
+  }
+  return hash;
+}
+
+/*
+* Open addressing with Robin Hood probing, elements that are far from their
+* slot take the place of closer ones, so probe lengths stay short and
+* lookups can stop early. Keys need a hash_key() overload, keys and values
+* are moved around as plain data. Lives inside an Arena, don't keep it
+* past a reset of the Arena!
+*/
+template<typename K, typename V>
+struct HashMap
+{
+  struct Slot
+  {
+    K key;
+    V value;
+    // Distance to the slot of the hash + 1, 0 means empty
+    unsigned int probeLength;
+  };
+
+  BumpAllocator* bumpAllocator;
+  AllocTag tag;
+  int count;
+  int capacity; // Always a power of 2
+  int shift; // 64 - log2(capacity), the upper bits of the hash are the slot
+  Slot* slots;
+
+  unsigned int get_slot_idx(K key)
+  {
+    return (unsigned int)(hash_key(key) >> shift);
+  }
+
+  V* find(K key)
+  {
+    if(!count)
+    {
+      return nullptr;
+    }
+
+    unsigned int mask = capacity - 1;
+    unsigned int idx = get_slot_idx(key);
+    for(unsigned int probeLength = 1;; probeLength++)
+    {
+      Slot& slot = slots[idx];
+      // Robin Hood, if the key was here it would have taken this slot
+      if(slot.probeLength < probeLength)
+      {
+        return nullptr;
+      }
+      if(slot.key == key)
+      {
+        return &slot.value;
+      }
+      idx = (idx + 1) & mask;
+    }
+  }
+
+  void reserve(int newCapacity)
+  {
+    if(newCapacity <= capacity)
+    {
+      return;
+    }
+    SM_ASSERT(bumpAllocator, "HashMap has no Arena, use make_hash_map()");
+
+    int powerOf2Capacity = 16;
+    int newShift = 64 - 4;
+    while(powerOf2Capacity < newCapacity)
+    {
+      powerOf2Capacity *= 2;
+      newShift--;
+    }
+
+    Slot* newSlots = (Slot*)bump_alloc(bumpAllocator, sizeof(Slot) * powerOf2Capacity, tag);
+    if(!newSlots)
+    {
+      return;
+    }
+    // Arena memory can be reused, it's not always 0
+    memset(newSlots, 0, sizeof(Slot) * powerOf2Capacity);
+
+    // The old slots stay in the Arena until it's reset
+    Slot* oldSlots = slots;
+    int oldCapacity = capacity;
+    slots = newSlots;
+    capacity = powerOf2Capacity;
+    shift = newShift;
+    count = 0;
+
+    for(int slotIdx = 0; slotIdx < oldCapacity; slotIdx++)
+    {
+      if(oldSlots[slotIdx].probeLength)
+      {
+        insert(oldSlots[slotIdx].key, oldSlots[slotIdx].value);
+      }
+    }
+  }
+
+  V* insert(K key, V value)
+  {
+    V* existing = find(key);
+    if(existing)
+    {
+      *existing = value;
+      return existing;
+    }
+
+    if((count + 1) * HASH_MAP_MAX_LOAD_DENOMINATOR > capacity * HASH_MAP_MAX_LOAD_NUMERATOR)
+    {
+      reserve(capacity? capacity * 2 : 16);
+    }
+    SM_ASSERT(count < capacity, "HashMap failed to grow!");
+
+    Slot insertSlot = {key, value, 1};
+    V* result = nullptr;
+
+    unsigned int mask = capacity - 1;
+    unsigned int idx = get_slot_idx(key);
+    while(true)
+    {
+      Slot& slot = slots[idx];
+      if(!slot.probeLength)
+      {
+        slot = insertSlot;
+        count++;
+        return result? result : &slot.value;
+      }
+
+      // Take from the rich, the element closer to it's slot moves on
+      if(slot.probeLength < insertSlot.probeLength)
+      {
+        Slot temp = slot;
+        slot = insertSlot;
+        insertSlot = temp;
+        if(!result)
+        {
+          result = &slot.value;
+        }
+      }
+
+      insertSlot.probeLength++;
+      idx = (idx + 1) & mask;
+    }
+  }
+
+  bool remove(K key)
+  {
+    V* value = find(key);
+    if(!value)
+    {
+      return false;
+    }
+
+    // Shift the following elements back, no tombstones needed
+    unsigned int mask = capacity - 1;
+    unsigned int idx = (unsigned int)((Slot*)((char*)value - offsetof(Slot, value)) - slots);
+    unsigned int nextIdx = (idx + 1) & mask;
+    while(slots[nextIdx].probeLength > 1)
+    {
+      slots[idx] = slots[nextIdx];
+      slots[idx].probeLength--;
+      idx = nextIdx;
+      nextIdx = (nextIdx + 1) & mask;
+    }
+    slots[idx] = {};
+    count--;
+
+    return true;
+  }
+
+  void clear()
+  {
+    if(slots)
+    {
+      memset(slots, 0, sizeof(Slot) * capacity);
+    }
+    count = 0;
+  }
+};
+
+template<typename K, typename V>
+HashMap<K, V> make_hash_map(BumpAllocator* bumpAllocator, int capacity = 0,
+                            AllocTag tag = ALLOC_TAG_UNTAGGED)
+{
+  HashMap<K, V> hashMap = {};
+  hashMap.bumpAllocator = bumpAllocator;
+  hashMap.tag = tag;
+  // Room for capacity elements without growing
+  hashMap.reserve(capacity * HASH_MAP_MAX_LOAD_DENOMINATOR / HASH_MAP_MAX_LOAD_NUMERATOR + 1);
+  return hashMap;
+}
+
+// #############################################################################
+//                           String Interning
+// #############################################################################
+// Turns strings into 32 bit IDs, the same string always gets the same ID.
+// Lives in the persistent storage, so the Game and the Platform share it
+struct StringInterner
+{
+  HashMap<unsigned long long, unsigned int> ids;
+  DynArray<int> offsets;
+  // Never grows, get_string() hands out pointers into it
+  DynArray<char> chars;
+};
+
+// 0 is never handed out, it means "no string"
+constexpr unsigned int STRING_ID_INVALID = 0;
+constexpr int MAX_INTERNED_STRINGS = 1024;
+constexpr int MAX_INTERNED_CHARS = KB(64);
+
+// Set by main() and passed to the Game in update_game()
+static StringInterner* stringInterner;
+
+StringInterner make_string_interner(BumpAllocator* bumpAllocator, int maxStrings, int maxChars)
+{
+  StringInterner interner = {};
+  interner.ids = make_hash_map<unsigned long long, unsigned int>(bumpAllocator, maxStrings);
+  interner.offsets = make_dyn_array<int>(bumpAllocator, maxStrings + 1);
+  interner.chars = make_dyn_array<char>(bumpAllocator, maxChars);
+
+  // STRING_ID_INVALID is the empty string
+  interner.offsets.add(0);
+  interner.chars.add(0);
+
+  return interner;
+}
+
+// Stays valid until the game closes, the chars are never moved
+const char* get_string(StringInterner* interner, unsigned int stringID)
+{
+  return &interner->chars[interner->offsets[stringID]];
+}
+
+// Returns STRING_ID_INVALID if the string was never interned
+unsigned int find_string_id(StringInterner* interner, const char* string)
+{
+  unsigned int* stringID = interner->ids.find(hash_string(string));
+  if(!stringID)
+  {
+    return STRING_ID_INVALID;
+  }
+
+  SM_ASSERT(strcmp(get_string(interner, *stringID), string) == 0, 
+            "String hash collision: %s, %s", get_string(interner, *stringID), string);
+  return *stringID;
+}
+
+unsigned int intern_string(StringInterner* interner, const char* string)
+{
+  unsigned int stringID = find_string_id(interner, string);
+  if(stringID)
+  {
+    return stringID;
+  }
+
+  // Growing would move the chars and every pointer get_string() returned
+  int length = (int)strlen(string);
+  if(interner->chars.count + length + 1 > interner->chars.capacity)
+  {
+    SM_ASSERT(false, "StringInterner is full, raise MAX_INTERNED_CHARS: %s", string);
+    return STRING_ID_INVALID;
+  }
+
+  stringID = interner->offsets.add(interner->chars.count);
+  for(const char* c = string; *c; c++)
+  {
+    interner->chars.add(*c);
+  }
+  interner->chars.add(0);
+  interner->ids.insert(hash_string(string), stringID);
+
+  return stringID;
+}
+
+// #############################################################################
+//                           Job System
+// #############################################################################
+constexpr int MAX_JOB_WORKERS = 16;
+// Per Worker, has to be a power of 2
+constexpr int JOB_QUEUE_CAPACITY = 4096;
+constexpr int CACHE_LINE_SIZE = 64;
+
+typedef void JobFunction(void* data);
+
+// Counts the unfinished Jobs of a batch, wait_for_counter() until it's 0
+struct JobCounter
+{
+  std::atomic<int> value;
+};
+
+// Owned by whoever runs the Jobs, it has to stay alive until the
+// JobCounter reached 0, the queues only store pointers
+struct Job
+{
+  JobFunction* function;
+  void* data;
+  JobCounter* counter;
+};
+
+/*
+* Chase-Lev work stealing deque, the owning Worker pushes and pops
+* at the bottom, the other Workers steal from the top
+*/
+struct JobQueue
+{
+  alignas(CACHE_LINE_SIZE) std::atomic<long long> top;
+  alignas(CACHE_LINE_SIZE) std::atomic<long long> bottom;
+  alignas(CACHE_LINE_SIZE) std::atomic<Job*> jobs[JOB_QUEUE_CAPACITY];
+};
+
+struct JobSystem
+{
+  bool initialized;
+  int workerCount; // Including the main thread
+  std::atomic<bool> running;
+  // Pushed and not yet taken, sleeping Workers wake up when this is > 0
+  std::atomic<int> pendingJobs;
+  std::mutex sleepMutex;
+  std::condition_variable sleepCondition;
+  std::thread threads[MAX_JOB_WORKERS];
+  JobQueue queues[MAX_JOB_WORKERS];
+};
+
+// Only main() starts the Job System, in the Game library
+// the Jobs just run serially on the calling thread
+static JobSystem jobSystem;
+// -1 for threads that are not Workers, they run Jobs inline
+static thread_local int jobWorkerIdx = -1;
+
+bool job_queue_push(JobQueue* queue, Job* job)
+{
+  long long bottom = queue->bottom.load(std::memory_order_relaxed);
+  long long top = queue->top.load(std::memory_order_acquire);
+  if(bottom - top >= JOB_QUEUE_CAPACITY)
+  {
+    return false;
+  }
+
+  // Release publishes the Job to the thieves
+  queue->jobs[bottom & (JOB_QUEUE_CAPACITY - 1)].store(job, std::memory_order_release);
+  queue->bottom.store(bottom + 1, std::memory_order_release);
+  return true;
+}
+
+Job* job_queue_pop(JobQueue* queue)
+{
+  long long bottom = queue->bottom.load(std::memory_order_relaxed) - 1;
+  queue->bottom.store(bottom, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  long long top = queue->top.load(std::memory_order_relaxed);
+
+  Job* job = nullptr;
+  if(top <= bottom)
+  {
+    job = queue->jobs[bottom & (JOB_QUEUE_CAPACITY - 1)].load(std::memory_order_relaxed);
+    if(top == bottom)
+    {
+      // Last Job, race the thieves for it
+      if(!queue->top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                             std::memory_order_relaxed))
+      {
+        job = nullptr;
+      }
+      queue->bottom.store(bottom + 1, std::memory_order_relaxed);
+    }
+  }
+  else
+  {
+    queue->bottom.store(bottom + 1, std::memory_order_relaxed);
+  }
+
+  return job;
+}
+
+Job* job_queue_steal(JobQueue* queue)
+{
+  long long top = queue->top.load(std::memory_order_acquire);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  long long bottom = queue->bottom.load(std::memory_order_acquire);
+
+  Job* job = nullptr;
+  if(top < bottom)
+  {
+    job = queue->jobs[top & (JOB_QUEUE_CAPACITY - 1)].load(std::memory_order_acquire);
+    if(!queue->top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                           std::memory_order_relaxed))
+    {
+      job = nullptr;
+    }
+  }
+
+  return job;
+}
+
+void execute_job(Job* job)
+{
+  job->function(job->data);
+  job->counter->value.fetch_sub(1, std::memory_order_release);
+}
+
+/*
+* Pops from the own queue first, then tries to steal from the others
+*/
+Job* get_job()
+{
+  Job* job = job_queue_pop(&jobSystem.queues[jobWorkerIdx]);
+  if(!job)
+  {
+    // Start at a different victim every time, so the Workers spread out
+    static thread_local unsigned int victimSeed = jobWorkerIdx * 7919 + 1;
+    victimSeed = victimSeed * 1664525 + 1013904223;
+
+    for(int victimIdx = 0; victimIdx < jobSystem.workerCount && !job; victimIdx++)
+    {
+      int queueIdx = (victimSeed + victimIdx) % jobSystem.workerCount;
+      if(queueIdx != jobWorkerIdx)
+      {
+        job = job_queue_steal(&jobSystem.queues[queueIdx]);
+      }
+    }
+  }
+
+  if(job)
+  {
+    jobSystem.pendingJobs.fetch_sub(1, std::memory_order_relaxed);
+  }
+  return job;
+}
+
+void job_worker_thread(int workerIdx)
+{
+  jobWorkerIdx = workerIdx;
+
+  while(jobSystem.running.load(std::memory_order_relaxed))
+  {
+    Job* job = get_job();
+    if(job)
+    {
+      execute_job(job);
+      continue;
+    }
+
+    // Nothing to do, sleep until new Jobs are pushed
+    std::unique_lock<std::mutex> lock(jobSystem.sleepMutex);
+    jobSystem.sleepCondition.wait(lock, []
+    {
+      return jobSystem.pendingJobs.load(std::memory_order_relaxed) > 0 ||
+             !jobSystem.running.load(std::memory_order_relaxed);
+    });
+  }
+}
+
+/*
+* Starts workerCount - 1 threads, the calling thread is Worker 0
+* and helps out in wait_for_counter(). 0 uses all cores
+*/
+void job_system_init(int workerCount = 0)
+{
+  if(workerCount <= 0)
+  {
+    workerCount = (int)std::thread::hardware_concurrency();
+  }
+  workerCount = workerCount < 1? 1 : workerCount;
+  workerCount = workerCount > MAX_JOB_WORKERS? MAX_JOB_WORKERS : workerCount;
+
+  jobSystem.workerCount = workerCount;
+  jobSystem.running = true;
+  jobWorkerIdx = 0;
+  for(int workerIdx = 1; workerIdx < workerCount; workerIdx++)
+  {
+    jobSystem.threads[workerIdx] = std::thread(job_worker_thread, workerIdx);
+  }
+  jobSystem.initialized = true;
+}
+
+void job_system_shutdown()
+{
+  if(!jobSystem.initialized)
+  {
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(jobSystem.sleepMutex);
+    jobSystem.running = false;
+  }
+  jobSystem.sleepCondition.notify_all();
+
+  for(int workerIdx = 1; workerIdx < jobSystem.workerCount; workerIdx++)
+  {
+    jobSystem.threads[workerIdx].join();
+  }
+  jobSystem.initialized = false;
+  jobWorkerIdx = -1;
+}
+
+/*
+* Adds count to the counter and queues the Jobs, they
+* can run on any Worker, including the calling one
+*/
+void run_jobs(Job* jobs, int count, JobCounter* counter)
+{
+  counter->value.fetch_add(count, std::memory_order_relaxed);
+
+  bool queued = false;
+  for(int jobIdx = 0; jobIdx < count; jobIdx++)
+  {
+    jobs[jobIdx].counter = counter;
+
+    if(jobWorkerIdx >= 0 && jobSystem.initialized &&
+       job_queue_push(&jobSystem.queues[jobWorkerIdx], &jobs[jobIdx]))
+    {
+      jobSystem.pendingJobs.fetch_add(1, std::memory_order_relaxed);
+      queued = true;
+    }
+    else
+    {
+      // No Job System or the queue is full
+      execute_job(&jobs[jobIdx]);
+    }
+  }
+
+  if(queued)
+  {
+    // Taking the lock makes sure no Worker misses the wake up
+    {
+      std::lock_guard<std::mutex> lock(jobSystem.sleepMutex);
+    }
+    jobSystem.sleepCondition.notify_all();
+  }
+}
+
+/*
+* Runs other Jobs while waiting, this is how Jobs depend on each other,
+* a Job can wait for the counter of the Jobs it needs
+*/
+void wait_for_counter(JobCounter* counter)
+{
+  while(counter->value.load(std::memory_order_acquire) > 0)
+  {
+    Job* job = jobWorkerIdx >= 0 && jobSystem.initialized? get_job() : nullptr;
+    if(job)
+    {
+      execute_job(job);
+    }
+    else
+    {
+      std::this_thread::yield();
+    }
+  }
+}
+
+typedef void ParallelForFunction(void* data, int start, int end);
+
+struct ParallelForBatch
+{
+  ParallelForFunction* function;
+  void* data;
+  int start;
+  int end;
+};
+
+void parallel_for_job(void* data)
+{
+  ParallelForBatch* batch = (ParallelForBatch*)data;
+  batch->function(batch->data, batch->start, batch->end);
+}
+
+/*
+* Calls function for [0, count) in batches of batchSize spread
+* over all Workers, returns once every batch is done
+*/
+void parallel_for(int count, int batchSize, ParallelForFunction* function, void* data)
+{
+  if(count <= 0)
+  {
+    return;
+  }
+  batchSize = batchSize < 1? 1 : batchSize;
+  int batchCount = (count + batchSize - 1) / batchSize;
+
+  TempArenaScope scratch(get_scratch());
+  Job* jobs = (Job*)bump_alloc(scratch.arena(), sizeof(Job) * batchCount);
+  ParallelForBatch* batches = 
+    (ParallelForBatch*)bump_alloc(scratch.arena(), sizeof(ParallelForBatch) * batchCount);
+
+  for(int batchIdx = 0; batchIdx < batchCount; batchIdx++)
+  {
+    batches[batchIdx].function = function;
+    batches[batchIdx].data = data;
+    batches[batchIdx].start = batchIdx * batchSize;
+    batches[batchIdx].end = batches[batchIdx].start + batchSize < count?
+                            batches[batchIdx].start + batchSize : count;
+    jobs[batchIdx] = {parallel_for_job, &batches[batchIdx]};
+  }
+
+  JobCounter counter = {};
+  run_jobs(jobs, batchCount, &counter);
+  wait_for_counter(&counter);
+}
+
+// #############################################################################
+//                           Ring Buffers
+// #############################################################################
+// Lock free queues to pass messages between threads. Both work from zeroed
+// memory and N has to be a power of 2. Producers and the consumer work on
+// different cache lines, so they don't slow each other down.
+
+/*
+* Exactly one thread pushes and exactly one thread pops
+*/
+template<typename T, int N>
+struct SPSCRing
+{
+  static_assert((N & (N - 1)) == 0, "SPSCRing size has to be a power of 2");
+  static constexpr int maxElements = N;
+
+  // Producer
+  alignas(CACHE_LINE_SIZE) std::atomic<unsigned int> tail;
+  unsigned int cachedHead; // Last head the producer saw, saves loading head
+
+  // Consumer
+  alignas(CACHE_LINE_SIZE) std::atomic<unsigned int> head;
+  unsigned int cachedTail;
+
+  alignas(CACHE_LINE_SIZE) T elements[N];
+
+  bool push(T element)
+  {
+    unsigned int pushIdx = tail.load(std::memory_order_relaxed);
+    if(pushIdx - cachedHead == N)
+    {
+      cachedHead = head.load(std::memory_order_acquire);
+      if(pushIdx - cachedHead == N)
+      {
+        return false;
+      }
+    }
+
+    elements[pushIdx & (N - 1)] = element;
+    tail.store(pushIdx + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool pop(T* element)
+  {
+    unsigned int popIdx = head.load(std::memory_order_relaxed);
+    if(popIdx == cachedTail)
+    {
+      cachedTail = tail.load(std::memory_order_acquire);
+      if(popIdx == cachedTail)
+      {
+        return false;
+      }
+    }
+
+    *element = elements[popIdx & (N - 1)];
+    head.store(popIdx + 1, std::memory_order_release);
+    return true;
+  }
+};
+
+/*
+* Any number of threads push, exactly one thread pops. Every slot has a
+* sequence number that tells if it's ready to be written or read. It's
+* stored relative to the slot index, so zeroed memory is a valid empty ring
+*/
+template<typename T, int N>
+struct MPSCRing
+{
+  static_assert((N & (N - 1)) == 0, "MPSCRing size has to be a power of 2");
+  static constexpr int maxElements = N;
+
+  struct Slot
+  {
+    std::atomic<unsigned int> sequence;
+    T element;
+  };
+
+  // Producers
+  alignas(CACHE_LINE_SIZE) std::atomic<unsigned int> tail;
+
+  // Consumer
+  alignas(CACHE_LINE_SIZE) unsigned int head;
+
+  alignas(CACHE_LINE_SIZE) Slot slots[N];
+
+  bool push(T element)
   {
-    count = 0;
+    unsigned int pushIdx = tail.load(std::memory_order_relaxed);
+    Slot* slot = nullptr;
+    while(true)
+    {
+      unsigned int slotIdx = pushIdx & (N - 1);
+      slot = &slots[slotIdx];
+      unsigned int sequence = slot->sequence.load(std::memory_order_acquire) + slotIdx;
+      int difference = (int)(sequence - pushIdx);
+
+      if(difference == 0)
+      {
+        // The slot is free, claim it
+        if(tail.compare_exchange_weak(pushIdx, pushIdx + 1, std::memory_order_relaxed))
+        {
+          break;
+        }
+      }
+      else if(difference < 0)
+      {
+        // The consumer didn't get to this slot yet
+        return false;
+      }
+      else
+      {
+        // Another producer was faster
+        pushIdx = tail.load(std::memory_order_relaxed);
+      }
+    }
+
+    slot->element = element;
+    slot->sequence.store(pushIdx + 1 - (pushIdx & (N - 1)), std::memory_order_release);
+    return true;
   }
 
-  bool is_full()
+  bool pop(T* element)
   {
-    return count == N;
+    unsigned int slotIdx = head & (N - 1);
+    Slot* slot = &slots[slotIdx];
+    unsigned int sequence = slot->sequence.load(std::memory_order_acquire) + slotIdx;
+    if((int)(sequence - (head + 1)) < 0)
+    {
+      return false;
+    }
+
+    *element = slot->element;
+    // Ready to be written again one lap later
+    slot->sequence.store(head + N - slotIdx, std::memory_order_release);
+    head++;
+    return true;
   }
 };
 
 // #############################################################################
-//                           Bump Allocator
+//                           Async Logging
 // #############################################################################
-struct BumpAllocator
+// Has to be a power of 2, when it's full the callers wait for the Logger
+constexpr int LOG_RING_CAPACITY = 1024;
+
+struct Logger
 {
-  size_t capacity;
-  size_t used;
-  char* memory;
+  std::atomic<bool> running;
+  std::thread thread;
+  // Only written by the Logger thread, log_flush() waits for it
+  std::atomic<unsigned int> writtenCount;
+  MPSCRing<LogMessage, LOG_RING_CAPACITY> messages;
 };
 
-BumpAllocator make_bump_allocator(size_t size)
+// Only main() starts the Logger, the Game library logs synchronously
+static Logger logger;
+
+bool log_push(LogMessage* message)
 {
-  BumpAllocator ba = {};
-  
-  ba.memory = (char*)malloc(size);
-  if(ba.memory)
+  if(!logger.running.load(std::memory_order_acquire))
   {
-    ba.capacity = size;
-    memset(ba.memory, 0, size); // Sets the memory to 0
+    return false;
   }
-  else
+
+  // Dropping messages would hide Errors, wait instead
+  while(!logger.messages.push(*message))
   {
-    SM_ASSERT(false, "Failed to allocate Memory!");
+    std::this_thread::yield();
   }
+  return true;
+}
 
-  return ba;
+void log_thread()
+{
+  char textBuffer[LOG_MESSAGE_SIZE];
+  LogMessage message;
+  while(true)
+  {
+    // Read before draining, so everything pushed before log_shutdown() is written
+    bool running = logger.running.load(std::memory_order_acquire);
+
+    while(logger.messages.pop(&message))
+    {
+      message.formatFunction(textBuffer, sizeof(textBuffer), message.format, message.payload);
+      log_write(message.prefix, textBuffer, message.textColor);
+      logger.writtenCount.fetch_add(1, std::memory_order_release);
+    }
+    fflush(stdout);
+
+    if(!running)
+    {
+      break;
+    }
+
+    // Messages are not urgent, polling is cheaper than waking up on every push
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
 }
 
-char* bump_alloc(BumpAllocator* bumpAllocator, size_t size)
+/*
+* From here on SM_TRACE, SM_WARN and SM_ERROR only copy their arguments, the
+* formatting and printing happens on the Logger thread
+*/
+void log_init()
 {
-  char* result = nullptr;
+  if(logger.running)
+  {
+    return;
+  }
 
-  size_t allignedSize = (size + 7) & ~ 7; // This makes sure the first 4 bits are 0 
-  if(bumpAllocator->used + allignedSize <= bumpAllocator->capacity)
+  logger.running = true;
+  logger.thread = std::thread(log_thread);
+  asyncLoggingEnabled = true;
+}
+
+void log_shutdown()
+{
+  if(!logger.running)
   {
-    result = bumpAllocator->memory + bumpAllocator->used;
-    bumpAllocator->used += allignedSize;
+    return;
   }
-  else
+
+  asyncLoggingEnabled = false;
+  logger.running = false;
+  logger.thread.join();
+}
+
+/*
+* Waits until every message pushed so far is written
+*/
+void log_flush()
+{
+  if(logger.running.load(std::memory_order_acquire) && 
+     logger.thread.get_id() != std::this_thread::get_id())
   {
-    SM_ASSERT(false, "BumpAllocator is full");
+    // Slots are claimed in order, so tail is the number of messages pushed
+    unsigned int pushedCount = logger.messages.tail.load(std::memory_order_acquire);
+    while((int)(logger.writtenCount.load(std::memory_order_acquire) - pushedCount) < 0)
+    {
+      std::this_thread::yield();
+    }
   }
 
-  return result;
+  fflush(stdout);
 }
 
 // #############################################################################
@@ -269,8 +1950,9 @@ char* read_file(const char* filePath, int* fileSize, char* buffer)
   *fileSize = ftell(file);
   fseek(file, 0, SEEK_SET);
 
-  memset(buffer, 0, *fileSize + 1);
-  fread(buffer, sizeof(char), *fileSize, file);
+  // Only the terminator needs clearing, fread() writes everything else
+  *fileSize = (int)fread(buffer, sizeof(char), *fileSize, file);
+  buffer[*fileSize] = 0;
 
   fclose(file);
 
@@ -279,17 +1961,69 @@ char* read_file(const char* filePath, int* fileSize, char* buffer)
 
 char* read_file(const char* filePath, int* fileSize, BumpAllocator* bumpAllocator)
 {
-  char* file = nullptr;
-  long fileSize2 = get_file_size(filePath);
+  SM_ASSERT(filePath, "No filePath supplied!");
+  SM_ASSERT(fileSize, "No fileSize supplied!");
 
-  if(fileSize2)
+  // The size and the contents come from the same open File
+  *fileSize = 0;
+  auto file = fopen(filePath, "rb");
+  if(!file)
+  {
+    SM_ERROR("Failed opening File: %s", filePath);
+    return nullptr;
+  }
+
+  fseek(file, 0, SEEK_END);
+  long size = ftell(file);
+  fseek(file, 0, SEEK_SET);
+
+  char* buffer = nullptr;
+  if(size > 0)
+  {
+    buffer = bump_alloc(bumpAllocator, size + 1, ALLOC_TAG_IO);
+    if(buffer)
+    {
+      *fileSize = (int)fread(buffer, sizeof(char), size, file);
+      buffer[*fileSize] = 0;
+    }
+  }
+
+  fclose(file);
+
+  return buffer; 
+}
+
+/*
+* Reads a file into malloc'd memory, free() it once done. Unlike a mapping,
+* the copy doesn't change or vanish when the file is rewritten
+*/
+char* read_file(const char* filePath, int* fileSize)
+{
+  SM_ASSERT(filePath, "No filePath supplied!");
+  SM_ASSERT(fileSize, "No fileSize supplied!");
+
+  *fileSize = 0;
+  auto file = fopen(filePath, "rb");
+  if(!file)
   {
-    char* buffer = bump_alloc(bumpAllocator, fileSize2 + 1);
+    SM_ERROR("Failed opening File: %s", filePath);
+    return nullptr;
+  }
+
+  fseek(file, 0, SEEK_END);
+  long size = ftell(file);
+  fseek(file, 0, SEEK_SET);
 
-    file = read_file(filePath, fileSize, buffer);
+  char* buffer = size > 0? (char*)malloc(size + 1) : nullptr;
+  if(buffer)
+  {
+    *fileSize = (int)fread(buffer, sizeof(char), size, file);
+    buffer[*fileSize] = 0;
   }
 
-  return file; 
+  fclose(file);
+
+  return buffer;
 }
 
 void write_file(const char* filePath, char* buffer, int size)
@@ -338,7 +2072,7 @@ bool copy_file(const char* fileName, const char* outputName, BumpAllocator* bump
 
   if(fileSize2)
   {
-    char* buffer = bump_alloc(bumpAllocator, fileSize2 + 1);
+    char* buffer = bump_alloc(bumpAllocator, fileSize2 + 1, ALLOC_TAG_IO);
 
     return copy_file(fileName, outputName, buffer);
   }
@@ -346,6 +2080,146 @@ bool copy_file(const char* fileName, const char* outputName, BumpAllocator* bump
   return false;
 }
 
+// #############################################################################
+//                           File Views
+// #############################################################################
+// Files mapped into memory, they are read in place by whoever needs them,
+// nothing is copied into our own memory. Views are read only.
+enum FileAccessHint
+{
+  FILE_ACCESS_NORMAL,
+  FILE_ACCESS_SEQUENTIAL, // Read front to back once, e.g. decoding a PNG
+  FILE_ACCESS_RANDOM,     // Jumps around, e.g. glyph lookups in a Font
+  FILE_ACCESS_WILL_NEED,  // Read ahead now, e.g. Sounds played from the view
+};
+
+struct FileView
+{
+  char* data;
+  long long size;
+};
+
+/*
+* Tells the OS how the view is going to be read, so it can read ahead or
+* not. Windows only gets the hint when the File is opened, see map_file()
+*/
+void advise_file_view(FileView view, FileAccessHint hint)
+{
+#ifndef _WIN32
+  if(!view.data)
+  {
+    return;
+  }
+
+  static int adviceTable[] =
+  {
+    MADV_NORMAL,     // FILE_ACCESS_NORMAL
+    MADV_SEQUENTIAL, // FILE_ACCESS_SEQUENTIAL
+    MADV_RANDOM,     // FILE_ACCESS_RANDOM
+    MADV_WILLNEED,   // FILE_ACCESS_WILL_NEED
+  };
+  madvise(view.data, view.size, adviceTable[hint]);
+#endif
+}
+
+/*
+* Empty Files and Files that don't exist return an empty view
+*/
+FileView map_file(const char* filePath, FileAccessHint hint = FILE_ACCESS_NORMAL)
+{
+  SM_ASSERT(filePath, "No filePath supplied!");
+
+  FileView view = {};
+
+#ifdef _WIN32
+  DWORD flags = FILE_ATTRIBUTE_NORMAL;
+  flags |= hint == FILE_ACCESS_SEQUENTIAL? FILE_FLAG_SEQUENTIAL_SCAN : 0;
+  flags |= hint == FILE_ACCESS_RANDOM? FILE_FLAG_RANDOM_ACCESS : 0;
+  HANDLE file = CreateFileA(filePath, GENERIC_READ, FILE_SHARE_READ, nullptr,
+                            OPEN_EXISTING, flags, nullptr);
+  if(file == INVALID_HANDLE_VALUE)
+  {
+    return view;
+  }
+
+  LARGE_INTEGER size = {};
+  GetFileSizeEx(file, &size);
+  if(size.QuadPart > 0)
+  {
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if(mapping)
+    {
+      view.data = (char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+      // The view keeps the mapping alive
+      CloseHandle(mapping);
+    }
+
+    if(view.data)
+    {
+      view.size = size.QuadPart;
+    }
+  }
+  CloseHandle(file);
+#else
+  int file = open(filePath, O_RDONLY);
+  if(file < 0)
+  {
+    return view;
+  }
+
+  struct stat fileStat = {};
+  fstat(file, &fileStat);
+  if(fileStat.st_size > 0)
+  {
+    char* data = (char*)mmap(nullptr, fileStat.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+    if(data != MAP_FAILED)
+    {
+      view.data = data;
+      view.size = fileStat.st_size;
+    }
+  }
+
+  // The mapping stays valid after closing the file
+  close(file);
+
+  if(hint != FILE_ACCESS_NORMAL)
+  {
+    advise_file_view(view, hint);
+  }
+#endif
+
+  return view;
+}
+
+/*
+* Reads one byte of every page, so the view is in memory before another
+* thread uses it. Background loads call this to keep the disk off the frame
+*/
+void touch_file_view(FileView view)
+{
+  long long pageSize = KB(4);
+
+  volatile char sum = 0;
+  for(long long offset = 0; offset < view.size; offset += pageSize)
+  {
+    sum += view.data[offset];
+  }
+}
+
+void unmap_file(FileView* view)
+{
+  if(view->data)
+  {
+#ifdef _WIN32
+    UnmapViewOfFile(view->data);
+#else
+    munmap(view->data, view->size);
+#endif
+  }
+
+  *view = {};
+}
+
 // #############################################################################
 //                           Math stuff
 // #############################################################################
@@ -517,9 +2391,15 @@ struct Vec4
     return values[idx];
   }
 
+  // Compares all components at once instead of branching on every one
   bool operator==(Vec4 other)
   {
-    return x == other.x && y == other.y && z == other.z && w == other.w;
+#ifdef SIMD_SSE2
+    __m128 equal = _mm_cmpeq_ps(_mm_loadu_ps(values), _mm_loadu_ps(other.values));
+    return _mm_movemask_ps(equal) == 0xF;
+#else
+    return (x == other.x) & (y == other.y) & (z == other.z) & (w == other.w);
+#endif
   }
 };
 
@@ -613,6 +2493,253 @@ bool rect_collision(IRect a, IRect b)
          a.pos.y + a.size.y > b.pos.y;    // Collision on Top of a and Bottom of b
 }
 
+// #############################################################################
+//                           SIMD Math
+// #############################################################################
+// Batch versions of the Math above. They work on Structure of Arrays, all x
+// values, then all y values, the SIMD lanes process multiple elements at once.
+// The remaining elements, and CPUs without SSE2, use the scalar functions.
+#ifdef SIMD_SSE2
+/*
+* SSE2 has no floor, truncating rounds negative numbers up, so step
+* those back down
+*/
+__m128 simd_floor(__m128 value)
+{
+  __m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(value));
+  __m128 roundedUp = _mm_cmpgt_ps(truncated, value);
+  return _mm_sub_ps(truncated, _mm_and_ps(roundedUp, _mm_set1_ps(1.0f)));
+}
+#endif
+
+Vec2 transform_point(Mat4 matrix, Vec2 point)
+{
+  return {matrix[0][0] * point.x + matrix[1][0] * point.y + matrix[3][0],
+          matrix[0][1] * point.x + matrix[1][1] * point.y + matrix[3][1]};
+}
+
+void lerp_batch(float* result, float* a, float* b, float t, int count)
+{
+  int idx = 0;
+
+#ifdef SIMD_AVX2
+  __m256 t8 = _mm256_set1_ps(t);
+  for(; idx + 8 <= count; idx += 8)
+  {
+    __m256 start8 = _mm256_loadu_ps(a + idx);
+    __m256 end8 = _mm256_loadu_ps(b + idx);
+    _mm256_storeu_ps(result + idx, 
+                     _mm256_add_ps(start8, _mm256_mul_ps(_mm256_sub_ps(end8, start8), t8)));
+  }
+#endif
+
+#ifdef SIMD_SSE2
+  __m128 t4 = _mm_set1_ps(t);
+  for(; idx + 4 <= count; idx += 4)
+  {
+    __m128 start4 = _mm_loadu_ps(a + idx);
+    __m128 end4 = _mm_loadu_ps(b + idx);
+    _mm_storeu_ps(result + idx, _mm_add_ps(start4, _mm_mul_ps(_mm_sub_ps(end4, start4), t4)));
+  }
+#endif
+
+  for(; idx < count; idx++)
+  {
+    result[idx] = lerp(a[idx], b[idx], t);
+  }
+}
+
+/*
+* Same as lerp(IVec2, IVec2, float) for every element, x and y
+* are interpolated the same way, so they are treated as one int array
+*/
+void lerp_batch(IVec2* result, IVec2* a, IVec2* b, float t, int count)
+{
+  int* resultValues = (int*)result;
+  int* aValues = (int*)a;
+  int* bValues = (int*)b;
+  int valueCount = count * 2;
+  int idx = 0;
+
+#ifdef SIMD_AVX2
+  __m256 t8 = _mm256_set1_ps(t);
+  for(; idx + 8 <= valueCount; idx += 8)
+  {
+    __m256 start8 = _mm256_cvtepi32_ps(_mm256_loadu_si256((__m256i*)(aValues + idx)));
+    __m256 end8 = _mm256_cvtepi32_ps(_mm256_loadu_si256((__m256i*)(bValues + idx)));
+    __m256 value = _mm256_add_ps(start8, _mm256_mul_ps(_mm256_sub_ps(end8, start8), t8));
+    _mm256_storeu_si256((__m256i*)(resultValues + idx), 
+                        _mm256_cvttps_epi32(_mm256_floor_ps(value)));
+  }
+#endif
+
+#ifdef SIMD_SSE2
+  __m128 t4 = _mm_set1_ps(t);
+  for(; idx + 4 <= valueCount; idx += 4)
+  {
+    __m128 start4 = _mm_cvtepi32_ps(_mm_loadu_si128((__m128i*)(aValues + idx)));
+    __m128 end4 = _mm_cvtepi32_ps(_mm_loadu_si128((__m128i*)(bValues + idx)));
+    __m128 value = _mm_add_ps(start4, _mm_mul_ps(_mm_sub_ps(end4, start4), t4));
+    _mm_storeu_si128((__m128i*)(resultValues + idx), _mm_cvttps_epi32(simd_floor(value)));
+  }
+#endif
+
+  for(; idx < valueCount; idx++)
+  {
+    resultValues[idx] = (int)floorf(lerp((float)aValues[idx], (float)bValues[idx], t));
+  }
+}
+
+/*
+* 2D points, z = 0 and w = 1, the results can be the input arrays
+*/
+void transform_points_batch(float* resultX, float* resultY, float* x, float* y, 
+                            int count, Mat4 matrix)
+{
+  int idx = 0;
+
+#ifdef SIMD_AVX2
+  __m256 xScaleX8 = _mm256_set1_ps(matrix[0][0]);
+  __m256 yScaleX8 = _mm256_set1_ps(matrix[1][0]);
+  __m256 offsetX8 = _mm256_set1_ps(matrix[3][0]);
+  __m256 xScaleY8 = _mm256_set1_ps(matrix[0][1]);
+  __m256 yScaleY8 = _mm256_set1_ps(matrix[1][1]);
+  __m256 offsetY8 = _mm256_set1_ps(matrix[3][1]);
+  for(; idx + 8 <= count; idx += 8)
+  {
+    __m256 x8 = _mm256_loadu_ps(x + idx);
+    __m256 y8 = _mm256_loadu_ps(y + idx);
+    __m256 transformedX = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(xScaleX8, x8), 
+                                                      _mm256_mul_ps(yScaleX8, y8)), offsetX8);
+    __m256 transformedY = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(xScaleY8, x8), 
+                                                      _mm256_mul_ps(yScaleY8, y8)), offsetY8);
+    _mm256_storeu_ps(resultX + idx, transformedX);
+    _mm256_storeu_ps(resultY + idx, transformedY);
+  }
+#endif
+
+#ifdef SIMD_SSE2
+  __m128 xScaleX4 = _mm_set1_ps(matrix[0][0]);
+  __m128 yScaleX4 = _mm_set1_ps(matrix[1][0]);
+  __m128 offsetX4 = _mm_set1_ps(matrix[3][0]);
+  __m128 xScaleY4 = _mm_set1_ps(matrix[0][1]);
+  __m128 yScaleY4 = _mm_set1_ps(matrix[1][1]);
+  __m128 offsetY4 = _mm_set1_ps(matrix[3][1]);
+  for(; idx + 4 <= count; idx += 4)
+  {
+    __m128 x4 = _mm_loadu_ps(x + idx);
+    __m128 y4 = _mm_loadu_ps(y + idx);
+    __m128 transformedX = _mm_add_ps(_mm_add_ps(_mm_mul_ps(xScaleX4, x4), 
+                                                _mm_mul_ps(yScaleX4, y4)), offsetX4);
+    __m128 transformedY = _mm_add_ps(_mm_add_ps(_mm_mul_ps(xScaleY4, x4), 
+                                                _mm_mul_ps(yScaleY4, y4)), offsetY4);
+    _mm_storeu_ps(resultX + idx, transformedX);
+    _mm_storeu_ps(resultY + idx, transformedY);
+  }
+#endif
+
+  for(; idx < count; idx++)
+  {
+    Vec2 point = transform_point(matrix, {x[idx], y[idx]});
+    resultX[idx] = point.x;
+    resultY[idx] = point.y;
+  }
+}
+
+/*
+* Bounding boxes of quads centered on their position, like get_transform() places them
+*/
+void build_aabbs_batch(float* minX, float* minY, float* maxX, float* maxY,
+                       float* posX, float* posY, float* sizeX, float* sizeY, int count)
+{
+  int idx = 0;
+
+#ifdef SIMD_AVX2
+  __m256 half8 = _mm256_set1_ps(0.5f);
+  for(; idx + 8 <= count; idx += 8)
+  {
+    __m256 sizeX8 = _mm256_loadu_ps(sizeX + idx);
+    __m256 sizeY8 = _mm256_loadu_ps(sizeY + idx);
+    __m256 minX8 = _mm256_sub_ps(_mm256_loadu_ps(posX + idx), _mm256_mul_ps(sizeX8, half8));
+    __m256 minY8 = _mm256_sub_ps(_mm256_loadu_ps(posY + idx), _mm256_mul_ps(sizeY8, half8));
+    _mm256_storeu_ps(minX + idx, minX8);
+    _mm256_storeu_ps(minY + idx, minY8);
+    _mm256_storeu_ps(maxX + idx, _mm256_add_ps(minX8, sizeX8));
+    _mm256_storeu_ps(maxY + idx, _mm256_add_ps(minY8, sizeY8));
+  }
+#endif
+
+#ifdef SIMD_SSE2
+  __m128 half4 = _mm_set1_ps(0.5f);
+  for(; idx + 4 <= count; idx += 4)
+  {
+    __m128 sizeX4 = _mm_loadu_ps(sizeX + idx);
+    __m128 sizeY4 = _mm_loadu_ps(sizeY + idx);
+    __m128 minX4 = _mm_sub_ps(_mm_loadu_ps(posX + idx), _mm_mul_ps(sizeX4, half4));
+    __m128 minY4 = _mm_sub_ps(_mm_loadu_ps(posY + idx), _mm_mul_ps(sizeY4, half4));
+    _mm_storeu_ps(minX + idx, minX4);
+    _mm_storeu_ps(minY + idx, minY4);
+    _mm_storeu_ps(maxX + idx, _mm_add_ps(minX4, sizeX4));
+    _mm_storeu_ps(maxY + idx, _mm_add_ps(minY4, sizeY4));
+  }
+#endif
+
+  for(; idx < count; idx++)
+  {
+    minX[idx] = posX[idx] - sizeX[idx] * 0.5f;
+    minY[idx] = posY[idx] - sizeY[idx] * 0.5f;
+    maxX[idx] = minX[idx] + sizeX[idx];
+    maxY[idx] = minY[idx] + sizeY[idx];
+  }
+}
+
+/*
+* Same as orthographic_projection() for every element, the four
+* planes of each projection are computed in the SIMD lanes
+*/
+void orthographic_projection_batch(Mat4* result, float* left, float* right, 
+                                   float* top, float* bottom, int count)
+{
+  int idx = 0;
+
+#ifdef SIMD_SSE2
+  __m128 signBit4 = _mm_set1_ps(-0.0f);
+  __m128 two4 = _mm_set1_ps(2.0f);
+  for(; idx + 4 <= count; idx += 4)
+  {
+    __m128 left4 = _mm_loadu_ps(left + idx);
+    __m128 right4 = _mm_loadu_ps(right + idx);
+    __m128 top4 = _mm_loadu_ps(top + idx);
+    __m128 bottom4 = _mm_loadu_ps(bottom + idx);
+    __m128 width4 = _mm_sub_ps(right4, left4);
+    __m128 height4 = _mm_sub_ps(top4, bottom4);
+
+    float scaleX[4], scaleY[4], offsetX[4], offsetY[4];
+    _mm_storeu_ps(scaleX, _mm_div_ps(two4, width4));
+    _mm_storeu_ps(scaleY, _mm_div_ps(two4, height4));
+    _mm_storeu_ps(offsetX, _mm_div_ps(_mm_xor_ps(_mm_add_ps(right4, left4), signBit4), width4));
+    _mm_storeu_ps(offsetY, _mm_div_ps(_mm_add_ps(top4, bottom4), height4));
+
+    for(int laneIdx = 0; laneIdx < 4; laneIdx++)
+    {
+      Mat4& projection = result[idx + laneIdx];
+      projection = {};
+      projection.aw = offsetX[laneIdx];
+      projection.bw = offsetY[laneIdx];
+      projection[0][0] = scaleX[laneIdx];
+      projection[1][1] = scaleY[laneIdx];
+      projection[2][2] = 1.0f;
+      projection[3][3] = 1.0f;
+    }
+  }
+#endif
+
+  for(; idx < count; idx++)
+  {
+    result[idx] = orthographic_projection(left[idx], right[idx], top[idx], bottom[idx]);
+  }
+}
+
 // #############################################################################
 //                           WAV File stuff
 // #############################################################################
@@ -654,23 +2781,59 @@ struct WAVFile
 	char dataBegin;
 };
 
-WAVFile* load_wav(char* path, BumpAllocator* bumpAllocator)
+/*
+* Checks the WAV File in memory, the PCM data is played straight out of
+* it, so it has to stay around as long as the Sound is used. Returns nullptr
+* for Files that are cut off or in a format we don't play, Hot Reloads
+* read whatever the editor left on disk
+*/
+WAVFile* get_wav_file(char* data, long long size, char* path)
 {
-	int fileSize = 0;
-	WAVFile* wavFile = (WAVFile*)read_file(path, &fileSize, bumpAllocator);
-	if(!wavFile) 
-  { 
-    SM_ASSERT(0, "Failed to load Wave File: %s", path);
-    return nullptr;
-  }
+	WAVFile* wavFile = (WAVFile*)data;
+	if(!wavFile || size < (long long)sizeof(WAVHeader)) 
+	{ 
+		SM_ERROR("Failed to load Wave File: %s", path);
+		return nullptr;
+	}
+
+	if(wavFile->header.numChannels != NUM_CHANNELS)
+	{
+		SM_ERROR("We only support 2 channels for now: %s", path);
+		return nullptr;
+	}
+
+	if(wavFile->header.sampleRate != SAMPLE_RATE)
+	{
+		SM_ERROR("We only support 44100 sample rate for now: %s", path);
+		return nullptr;
+	}
+
+	if(memcmp(&wavFile->header.dataChunkId, "data", 4) != 0)
+	{
+		SM_ERROR("WAV File not in propper format: %s", path);
+		return nullptr;
+	}
+
+	if(sizeof(WAVHeader) + (long long)wavFile->header.dataChunkSize > size)
+	{
+		SM_ERROR("WAV File is cut off: %s", path);
+		return nullptr;
+	}
 
-	SM_ASSERT(wavFile->header.numChannels == NUM_CHANNELS, 
-            "We only support 2 channels for now!");
-	SM_ASSERT(wavFile->header.sampleRate == SAMPLE_RATE, 
-            "We only support 44100 sample rate for now!");
+	return wavFile;
+}
 
-	SM_ASSERT(memcmp(&wavFile->header.dataChunkId, "data", 4) == 0, 
-						"WAV File not in propper format");
+/*
+* The WAV File is mapped and never copied, it has to stay mapped as long as the Sound is used
+*/
+WAVFile* load_wav(char* path, FileView* fileView)
+{
+	*fileView = map_file(path, FILE_ACCESS_WILL_NEED);
+	WAVFile* wavFile = get_wav_file(fileView->data, fileView->size, path);
+	if(!wavFile)
+	{
+		unmap_file(fileView);
+	}
 
 	return wavFile;
 }
@@ -5,6 +5,7 @@
 #define vec2 Vec2
 #define ivec2 IVec2
 #define vec4 Vec4
+#define mat4 Mat4
 
 // Inside Shader
 #else 
@@ -21,6 +22,15 @@ int RENDERING_OPTION_FLIP_X = BIT(0);
 int RENDERING_OPTION_FLIP_Y = BIT(1);
 int RENDERING_OPTION_FONT = BIT(2);
 
+// Has to be a define, the Shader uses it to size the Camera Uniform Block
+#define MAX_CAMERAS 8
+
+// Texture Units, binding = N in quad.frag reads GL_TEXTURE0 + N
+#define FONT_TEXTURE_UNIT 1
+// One Unit per AtlasID from here on, see sprite_table.h
+#define ATLAS_TEXTURE_UNIT 2
+#define MAX_ATLASES 4
+
 // #############################################################################
 //                           Rendering Structs
 // #############################################################################
@@ -33,7 +43,15 @@ struct Transform
   int renderOptions;
   int materialIdx;
   float layer;
-  int padding;
+  int cameraIdx;
+  int atlasIdx; // AtlasID, Fonts ignore it
+  int padding;  // std430 rounds the struct up to the vec2 alignment
+};
+
+struct Camera
+{
+  mat4 viewProjection;
+  vec4 viewport; // Normalized x, y, width, height, origin is Top Left
 };
 
 struct Material
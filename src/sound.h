@@ -5,7 +5,6 @@
 //                           Sound Constants
 // #############################################################################
 static constexpr int MAX_CONCURRENT_SOUNDS = 16;
-static constexpr int SOUNDS_BUFFER_SIZE = MB(128);
 static constexpr int MAX_SOUND_PATH_LENGTH = 256;
 
 static constexpr float FADE_DURATION = 1.0f;
@@ -26,17 +25,20 @@ struct Sound
 {
 	char file[MAX_SOUND_PATH_LENGTH];
 	SoundOptions options;
+	// Options of a play_sound() that came in while the Sound was loading
+	SoundOptions pendingOptions;
 	int size;
-	char* data;
+	char* data; // nullptr until the Sound is loaded
 };
 
 struct SoundState
 {
-	// Buffer containing all Sounds
-	int bytesUsed;
-	char* allocatedsoundsBuffer;
+	// Sounds are played out of the Asset Pack or a copy of their WAV File,
+	// the Bytes of the loaded versions, see sound_loader.h
+	long long loadedBytes;
 
-	BumpAllocator* transientStorage;
+	// Interned Sound file -> Index into allocatedSounds
+	HashMap<unsigned int, int> soundLookup;
 
 	// Allocted sounds
 	Array<Sound, MAX_CONCURRENT_SOUNDS> allocatedSounds;
@@ -73,37 +75,30 @@ void play_sound(char* soundName, SoundOptions options = 0)
 	sprintf(sound.file, "assets/sounds/%s.wav", soundName);
 
 	// Look for existing Sound to play
-	for(int soundIdx = 0; soundIdx < soundState->allocatedSounds.count; soundIdx++)
+	unsigned int soundFileID = intern_string(stringInterner, sound.file);
+	int* allocatedSoundIdx = soundState->soundLookup.find(soundFileID);
+	if(allocatedSoundIdx)
 	{
-		Sound allocatedSound = soundState->allocatedSounds[soundIdx];
-
-		if(strcmp(allocatedSound.file, sound.file) == 0)
-		{
-			// Use allocated Sound
-			allocatedSound.options = sound.options;
-			soundState->playingSounds.add(allocatedSound);
-			return;
-		}
-	}
-
-	// Couldn't find a Sound, Load WAV file if presend and allocate
-	WAVFile* wavFile = load_wav(sound.file, soundState->transientStorage);
-	if(wavFile)
-	{
-		if(wavFile->header.dataChunkSize > SOUNDS_BUFFER_SIZE - soundState->bytesUsed)
+		Sound& allocatedSound = soundState->allocatedSounds[*allocatedSoundIdx];
+		if(!allocatedSound.data)
 		{
-			SM_ASSERT(0, "Exausted Sounds Buffer!\nCapacity:\t%d\nBytes Used:\t%d\nSound Path:\t%s\nSound Size:\t%d",
-									 SOUNDS_BUFFER_SIZE, soundState->bytesUsed, sound.file, wavFile->header.dataChunkSize);
+			// Still loading, it plays as soon as it's loaded
+			allocatedSound.pendingOptions = sound.options;
 			return;
 		}
-		sound.size = wavFile->header.dataChunkSize;
-		sound.data = &soundState->allocatedsoundsBuffer[soundState->bytesUsed];
-		soundState->bytesUsed += sound.size;
-		memcpy(sound.data, &wavFile->dataBegin, sound.size);
 
-		soundState->allocatedSounds.add(sound);
-		soundState->playingSounds.add(sound);
+		// Use allocated Sound
+		Sound playingSound = allocatedSound;
+		playingSound.options = sound.options;
+		soundState->playingSounds.add(playingSound);
+		return;
 	}
+
+	// Couldn't find a Sound, the engine loads it in the background
+	// and plays it once it's there, see update_sounds() in sound_loader.h
+	sound.pendingOptions = sound.options;
+	int soundIdx = soundState->allocatedSounds.add(sound);
+	soundState->soundLookup.insert(soundFileID, soundIdx);
 }
 
 void stop_sound(char* soundName)
@@ -0,0 +1,203 @@
+#pragma once
+
+#include "schnitzel_lib.h"
+#include "platform.h"
+#include "sound.h"
+#include "file_watcher.h"
+#include "asset_loader.h"
+
+// #############################################################################
+//                           Sound Loader Constants
+// #############################################################################
+// Every Voice and every queued play can hold on to an old version, so this never runs out
+constexpr int MAX_RETIRED_SOUNDS = MAX_CONCURRENT_SOUNDS * 2;
+
+// #############################################################################
+//                           Sound Loader Structs
+// #############################################################################
+/*
+* The memory one version of a Sound plays from
+*/
+struct SoundMemory
+{
+  char* data;   // What Sound::data points to
+  char* memory; // malloc'd, nullptr when the data is read in place out of the Asset Pack
+  long long size;
+};
+
+/*
+* play_sound() only registers new Sounds, the Engine loads them
+* through the Asset Loader and reloads them when their WAV File changes
+*/
+struct SoundLoader
+{
+  int requestedCount;
+  AssetHandle assets[MAX_CONCURRENT_SOUNDS];
+  int watchIdxs[MAX_CONCURRENT_SOUNDS];
+
+  SoundMemory loaded[MAX_CONCURRENT_SOUNDS];
+  // Replaced by a reload, freed once nothing plays them anymore
+  Array<SoundMemory, MAX_RETIRED_SOUNDS> retired;
+};
+
+// #############################################################################
+//                           Sound Loader Globals
+// #############################################################################
+static SoundLoader soundLoader;
+
+// #############################################################################
+//                           Sound Loader Functions
+// #############################################################################
+/*
+* Sounds in the Asset Pack are played straight out of it. Loose WAV Files
+* are read into their own memory, editors truncate and rewrite them, and
+* the mixer would crash reading a mapping of the old file
+*/
+bool decode_sound_asset(Asset* asset)
+{
+  if(asset->loose || !find_asset_pack_entry(asset->path))
+  {
+    int fileSize = 0;
+    char* fileData = read_file(asset->path, &fileSize);
+    if(!fileData || !get_wav_file(fileData, fileSize, asset->path))
+    {
+      free(fileData);
+      return false;
+    }
+
+    asset->decoded = fileData;
+    return true;
+  }
+
+  asset->file = open_asset_file(asset->path, FILE_ACCESS_WILL_NEED);
+  if(!get_wav_file(asset->file.data, asset->file.size, asset->path))
+  {
+    close_asset_file(&asset->file);
+    return false;
+  }
+
+  // The first play doesn't wait for the disk
+  touch_file_view({asset->file.data, asset->file.size});
+  return true;
+}
+
+bool sound_memory_in_use(SoundMemory* soundMemory)
+{
+  for(int soundIdx = 0; soundIdx < soundState->playingSounds.count; soundIdx++)
+  {
+    if(soundState->playingSounds[soundIdx].data == soundMemory->data)
+    {
+      return true;
+    }
+  }
+
+  return platform_is_playing_sound_data(soundMemory->data);
+}
+
+void free_sound_memory(SoundMemory* soundMemory)
+{
+  free(soundMemory->memory);
+  soundState->loadedBytes -= soundMemory->size;
+  *soundMemory = {};
+}
+
+/*
+* Frees the old versions of reloaded Sounds that stopped playing
+*/
+void free_retired_sounds()
+{
+  for(int retiredIdx = 0; retiredIdx < soundLoader.retired.count; retiredIdx++)
+  {
+    if(!sound_memory_in_use(&soundLoader.retired[retiredIdx]))
+    {
+      free_sound_memory(&soundLoader.retired[retiredIdx]);
+      soundLoader.retired.remove_idx_and_swap(retiredIdx--);
+    }
+  }
+}
+
+bool finalize_sound_asset(Asset* asset)
+{
+  Sound& sound = soundState->allocatedSounds[asset->param];
+  SoundMemory* loaded = &soundLoader.loaded[asset->param];
+
+  // The Sound takes over the memory, finalize_asset() only frees what is left
+  SoundMemory soundMemory = {};
+  if(asset->decoded)
+  {
+    soundMemory.memory = (char*)asset->decoded;
+    asset->decoded = nullptr;
+  }
+  else
+  {
+    soundMemory.memory = asset->file.decompressed? asset->file.data : nullptr;
+  }
+  WAVFile* wavFile = (WAVFile*)(soundMemory.memory? soundMemory.memory : asset->file.data);
+  soundMemory.data = &wavFile->dataBegin;
+  soundMemory.size = sizeof(WAVHeader) + wavFile->header.dataChunkSize;
+  asset->file = {};
+
+  // Sounds that are still playing keep reading the old version
+  bool reloaded = loaded->data;
+  if(reloaded)
+  {
+    if(sound_memory_in_use(loaded))
+    {
+      free_retired_sounds();
+      SM_ASSERT(!soundLoader.retired.is_full(), "Too many old Sound versions playing");
+      soundLoader.retired.add(*loaded);
+    }
+    else
+    {
+      free_sound_memory(loaded);
+    }
+  }
+
+  *loaded = soundMemory;
+  soundState->loadedBytes += soundMemory.size;
+  sound.size = wavFile->header.dataChunkSize;
+  sound.data = soundMemory.data;
+  asset->size = (int)soundMemory.size;
+
+  if(reloaded)
+  {
+    SM_TRACE("Reloaded Sound: %s", sound.file);
+  }
+
+  // play_sound() was called while the Sound was loading
+  if(sound.pendingOptions)
+  {
+    Sound playingSound = sound;
+    playingSound.options = sound.pendingOptions;
+    soundState->playingSounds.add(playingSound);
+    sound.pendingOptions = 0;
+  }
+
+  return true;
+}
+
+/*
+* Called once per frame, requests the Sounds play_sound() registered, they
+* start playing once they are finalized. Changed WAV Files are loaded again
+*/
+void update_sounds()
+{
+  for(; soundLoader.requestedCount < soundState->allocatedSounds.count;
+      soundLoader.requestedCount++)
+  {
+    int soundIdx = soundLoader.requestedCount;
+    Sound& sound = soundState->allocatedSounds[soundIdx];
+    soundLoader.assets[soundIdx] = request_asset(ASSET_TYPE_SOUND, sound.file, soundIdx);
+    soundLoader.watchIdxs[soundIdx] = watch_file(sound.file);
+  }
+
+  for(int soundIdx = 0; soundIdx < soundLoader.requestedCount; soundIdx++)
+  {
+    if(file_changed(soundLoader.watchIdxs[soundIdx]))
+    {
+      reload_asset(soundLoader.assets[soundIdx]);
+    }
+  }
+
+  free_retired_sounds();
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+// #############################################################################
+//                 Generated by src/cooker.cpp, DO NOT EDIT!
+// #############################################################################
+// Sprites are Slices inside of the Aseprite files in assets/textures
+
+enum AtlasID
+{
+  ATLAS_MASTER,
+  ATLAS_ENEMIES,
+  ATLAS_PROJECTILES,
+
+  ATLAS_COUNT
+};
+
+// The Renderer loads an Atlas the first time one of it's Sprites is drawn
+constexpr const char* ATLAS_TEXTURE_PATHS[ATLAS_COUNT] =
+{
+  "assets/textures/TEXTURE_ATLAS.png", // ATLAS_MASTER
+  "assets/textures/TEXTURE_ATLAS_ENEMIES.png", // ATLAS_ENEMIES
+  "assets/textures/TEXTURE_ATLAS_PROJECTILES.png", // ATLAS_PROJECTILES
+};
+
+enum SpriteID
+{
+  SPRITE_WHITE,
+  SPRITE_DICE,
+  SPRITE_CELESTE,
+  SPRITE_CELESTE_RUN,
+  SPRITE_CELESTE_ATTACK,
+  SPRITE_SOLID_01,
+  SPRITE_SOLID_02,
+  SPRITE_BUTTON_PLAY,
+  SPRITE_BUTTON_SAVE,
+  SPRITE_TILE_GRASS_01,
+  SPRITE_BASIC_PROJECTILE,
+
+  SPRITE_COUNT
+};
+
+constexpr Sprite SPRITE_TABLE[SPRITE_COUNT] =
+{
+  {{0, 0}, {1, 1}, 1, ATLAS_MASTER}, // SPRITE_WHITE
+  {{16, 0}, {16, 16}, 1, ATLAS_MASTER}, // SPRITE_DICE
+  {{112, 0}, {17, 20}, 1, ATLAS_MASTER}, // SPRITE_CELESTE
+  {{128, 0}, {17, 20}, 12, ATLAS_MASTER}, // SPRITE_CELESTE_RUN
+  {{229, 0}, {17, 20}, 1, ATLAS_MASTER}, // SPRITE_CELESTE_ATTACK
+  {{0, 16}, {28, 18}, 1, ATLAS_MASTER}, // SPRITE_SOLID_01
+  {{32, 16}, {16, 13}, 1, ATLAS_MASTER}, // SPRITE_SOLID_02
+  {{80, 0}, {32, 16}, 1, ATLAS_MASTER}, // SPRITE_BUTTON_PLAY
+  {{80, 16}, {32, 16}, 1, ATLAS_MASTER}, // SPRITE_BUTTON_SAVE
+  {{112, 32}, {95, 95}, 1, ATLAS_MASTER}, // SPRITE_TILE_GRASS_01
+  {{35, 35}, {10, 10}, 1, ATLAS_PROJECTILES}, // SPRITE_BASIC_PROJECTILE
+};
@@ -1,6 +1,7 @@
 
 #include "platform.h"
 #include "schnitzel_lib.h"
+#include "file_watcher.h"
 
 #define WIN32_LEAN_AND_MEAN
 #define NOMINMAX
@@ -11,25 +12,29 @@
 // #############################################################################
 //                           Windows Structures
 // #############################################################################
+// The XAudio thread reports Voices that finished playing, drained on the main thread
+static SPSCRing<int, MAX_CONCURRENT_SOUNDS> finishedVoices;
+
 struct xAudioVoice : IXAudio2VoiceCallback
 {
 	IXAudio2SourceVoice* voice;
   SoundOptions options;
   float fadeTimer;
   char* soundPath;
+  // The Sound data the submitted buffer points to
+  char* soundData;
+  int voiceIdx;
 
-  int playing;
+  // Only used on the main thread, see finishedVoices
+  bool playing;
 
 	void OnStreamEnd() noexcept
 	{
 		voice->Stop();
-    playing = false;
+    finishedVoices.push(voiceIdx);
 	}
 
-	void OnBufferStart(void * pBufferContext) noexcept
-	{
-    playing = true;
-	}
+	void OnBufferStart(void * pBufferContext) noexcept {}
 
 	void OnVoiceProcessingPassEnd() noexcept {}
 	void OnVoiceProcessingPassStart(UINT32 SamplesRequired) noexcept {}
@@ -47,6 +52,11 @@ static HDC dc;
 static PFNWGLSWAPINTERVALEXTPROC wglSwapIntervalEXT_ptr;
 static xAudioVoice voiceArr[MAX_CONCURRENT_SOUNDS];
 
+// Signaled to shut down, or to pick up newly watched Directories
+static HANDLE fileWatcherWakeEvent;
+static std::atomic<bool> fileWatcherRunning;
+static std::thread fileWatcherThread;
+
 // #############################################################################
 //                           Platform Implementations
 // #############################################################################
@@ -381,10 +391,21 @@ void platform_set_vsync(bool vSync)
   wglSwapIntervalEXT_ptr(vSync);
 }
 
+bool platform_link_file(const char* fileName, const char* linkName)
+{
+  // The linker can't overwrite a loaded dll, not even through a hard link, so
+  // the dll is copied. This runs on the loader thread, not in the frame
+  return CopyFileA(fileName, linkName, FALSE);
+}
+
 void* platform_load_dynamic_library(const char* dll)
 {
   HMODULE result = LoadLibraryA(dll);
-  SM_ASSERT(result, "Failed to load dll: %s", dll);
+  if(!result)
+  {
+    // A reload can catch the dll half written, the caller tries again
+    SM_ERROR("Failed to load dll: %s", dll);
+  }
 
   return result;
 }
@@ -543,6 +564,7 @@ bool platform_init_audio()
 	for(int voiceIdx = 0; voiceIdx < MAX_CONCURRENT_SOUNDS; voiceIdx++)
 	{
 		xAudioVoice* voice = &voiceArr[voiceIdx];
+		voice->voiceIdx = voiceIdx;
 		hr = xaudio2->CreateSourceVoice(&voice->voice, &wave, 0, XAUDIO2_DEFAULT_FREQ_RATIO, voice, nullptr, nullptr);
 		voice->voice->SetVolume(musicVolume);
 		if(FAILED(hr)) { return false; }
@@ -553,6 +575,13 @@ bool platform_init_audio()
 
 void platform_update_audio(float dt)
 {
+  // Free the Voices the XAudio thread finished
+  int finishedVoiceIdx;
+  while(finishedVoices.pop(&finishedVoiceIdx))
+  {
+    voiceArr[finishedVoiceIdx].playing = false;
+  }
+
   for(int soundIdx = 0; soundIdx < soundState->playingSounds.count; soundIdx++)
   {
     Sound& sound = soundState->playingSounds[soundIdx];
@@ -587,8 +616,9 @@ void platform_update_audio(float dt)
         {
           voice->voice->Start();
           voice->soundPath = sound.file;
+          voice->soundData = sound.data;
           voice->options = sound.options;
-		      InterlockedExchange((LONG*)&voice->playing, true);
+          voice->playing = true;
         }
       }
     }
@@ -655,7 +685,171 @@ void platform_update_audio(float dt)
   soundState->playingSounds.count = 0;
 }
 
+bool platform_is_playing_sound_data(char* data)
+{
+  for(int voiceIdx = 0; voiceIdx < MAX_CONCURRENT_SOUNDS; voiceIdx++)
+  {
+    if(voiceArr[voiceIdx].playing && voiceArr[voiceIdx].soundData == data)
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+
 void platform_sleep(unsigned int ms)
 {
   Sleep(ms);
-}
\ No newline at end of file
+}
+
+long long platform_get_time_ns()
+{
+  static LARGE_INTEGER frequency = {};
+  if(!frequency.QuadPart)
+  {
+    QueryPerformanceFrequency(&frequency);
+  }
+
+  LARGE_INTEGER counter = {};
+  QueryPerformanceCounter(&counter);
+
+  // Split the conversion, counter * 1e9 would overflow after a few hours
+  long long seconds = counter.QuadPart / frequency.QuadPart;
+  long long remainder = counter.QuadPart % frequency.QuadPart;
+  return seconds * 1000000000LL + remainder * 1000000000LL / frequency.QuadPart;
+}
+
+void platform_sleep_until(long long timeNs)
+{
+  // High resolution timers are available since Windows 10 1803, 
+  // Sleep() would round us up to the 15.6ms scheduler tick
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+  static HANDLE timer = CreateWaitableTimerExW(nullptr, nullptr, 
+                                               CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, 
+                                               TIMER_ALL_ACCESS);
+
+  long long remainingNs = timeNs - platform_get_time_ns();
+  if(remainingNs <= 0)
+  {
+    return;
+  }
+
+  if(!timer)
+  {
+    Sleep((DWORD)(remainingNs / 1000000));
+    return;
+  }
+
+  // Negative means relative, in 100ns units
+  LARGE_INTEGER dueTime = {};
+  dueTime.QuadPart = -(remainingNs / 100);
+  SetWaitableTimer(timer, &dueTime, 0, nullptr, nullptr, FALSE);
+  WaitForSingleObject(timer, INFINITE);
+}
+
+void win32_file_watcher_thread()
+{
+  DWORD timeoutMs = INFINITE;
+  while(fileWatcherRunning)
+  {
+    // Rebuilt every time, files might have been added
+    HANDLE handles[MAX_WATCHED_FILES + 1] = {fileWatcherWakeEvent};
+    int watchCount = fileWatcher.watchCount.load(std::memory_order_acquire);
+    for(int watchIdx = 0; watchIdx < watchCount; watchIdx++)
+    {
+      handles[watchIdx + 1] = (HANDLE)fileWatcher.files[watchIdx].platformWatchID;
+    }
+
+    DWORD result = WaitForMultipleObjects(watchCount + 1, handles, FALSE, timeoutMs);
+    long long timeNs = platform_get_time_ns();
+    if(result > WAIT_OBJECT_0 && result <= WAIT_OBJECT_0 + watchCount)
+    {
+      WatchedFile* signaledFile = &fileWatcher.files[result - WAIT_OBJECT_0 - 1];
+      FindNextChangeNotification((HANDLE)signaledFile->platformWatchID);
+
+      // Windows only reports that something in the Directory changed
+      for(int watchIdx = 0; watchIdx < watchCount; watchIdx++)
+      {
+        WatchedFile* watchedFile = &fileWatcher.files[watchIdx];
+        if(strcmp(watchedFile->directory, signaledFile->directory) != 0)
+        {
+          continue;
+        }
+
+        long long timestamp = get_timestamp(watchedFile->path);
+        if(timestamp != watchedFile->lastTimestamp)
+        {
+          watchedFile->lastTimestamp = timestamp;
+          file_watcher_touch(watchIdx, timeNs);
+        }
+      }
+    }
+
+    int publishTimeoutMs = file_watcher_publish(timeNs);
+    timeoutMs = publishTimeoutMs < 0? INFINITE : (DWORD)publishTimeoutMs;
+  }
+}
+
+bool platform_init_file_watcher()
+{
+  fileWatcherWakeEvent = CreateEventA(nullptr, FALSE, FALSE, nullptr);
+  if(!fileWatcherWakeEvent)
+  {
+    SM_ERROR("Failed to create the File Watcher Event");
+    return false;
+  }
+
+  fileWatcherRunning = true;
+  fileWatcherThread = std::thread(win32_file_watcher_thread);
+  return true;
+}
+
+void platform_shutdown_file_watcher()
+{
+  if(fileWatcherThread.joinable())
+  {
+    fileWatcherRunning = false;
+    SetEvent(fileWatcherWakeEvent);
+    fileWatcherThread.join();
+  }
+
+  int watchCount = fileWatcher.watchCount.load(std::memory_order_acquire);
+  for(int watchIdx = 0; watchIdx < watchCount; watchIdx++)
+  {
+    FindCloseChangeNotification((HANDLE)fileWatcher.files[watchIdx].platformWatchID);
+  }
+
+  if(fileWatcherWakeEvent)
+  {
+    CloseHandle(fileWatcherWakeEvent);
+    fileWatcherWakeEvent = nullptr;
+  }
+}
+
+bool platform_watch_directory(WatchedFile* watchedFile)
+{
+  if(!fileWatcherWakeEvent)
+  {
+    return false;
+  }
+
+  HANDLE handle = FindFirstChangeNotificationA(watchedFile->directory, FALSE,
+                                               FILE_NOTIFY_CHANGE_LAST_WRITE | 
+                                               FILE_NOTIFY_CHANGE_FILE_NAME);
+  if(handle == INVALID_HANDLE_VALUE)
+  {
+    return false;
+  }
+
+  watchedFile->platformWatchID = (long long)handle;
+  return true;
+}
+
+void platform_wake_file_watcher()
+{
+  // The thread has to wait on the new handles as well
+  SetEvent(fileWatcherWakeEvent);
+}
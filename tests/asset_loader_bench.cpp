@@ -0,0 +1,152 @@
+#include "engine_harness.h"
+
+// #############################################################################
+//                           Asset Loader Bench Constants
+// #############################################################################
+// Wall clock time of loading every Asset one after the other against
+// requesting all of them and waiting once, the Workers decode them side by side.
+// Needs a Window, run it from the repository root after the Cooker
+const char* BENCH_SOUND_PATHS[] =
+{
+  "assets/sounds/jump.wav",
+  "assets/sounds/died.wav",
+};
+
+// #############################################################################
+//                           Asset Loader Bench Globals
+// #############################################################################
+static Array<AssetHandle, MAX_ASSETS> atlasHandles;
+static Array<AssetHandle, MAX_ASSETS> assetHandles;
+
+// #############################################################################
+//                           Asset Loader Bench Functions
+// #############################################################################
+/*
+* Every Atlas, the Font and the Sounds, the Sounds are registered like
+* play_sound() does it, without playing them
+*/
+void bench_request_every_asset()
+{
+  for(int atlasIdx = 0; atlasIdx < ATLAS_COUNT; atlasIdx++)
+  {
+    AssetHandle handle = request_asset(ASSET_TYPE_TEXTURE, ATLAS_TEXTURE_PATHS[atlasIdx]);
+    atlasResidency.atlases[atlasIdx].handle = handle;
+    atlasHandles.add(handle);
+    assetHandles.add(handle);
+  }
+  assetHandles.add(glContext.startupAssets[1]);
+
+  for(int soundIdx = 0; soundIdx < ArraySize(BENCH_SOUND_PATHS); soundIdx++)
+  {
+    Sound sound = {};
+    strcpy(sound.file, BENCH_SOUND_PATHS[soundIdx]);
+    soundState->allocatedSounds.add(sound);
+    assetHandles.add(request_asset(ASSET_TYPE_SOUND, sound.file, soundIdx));
+  }
+}
+
+/*
+* The Atlases are the only Assets that can be unloaded,
+* requesting them again reads them out of the Asset Pack
+*/
+void bench_request_atlases(bool serial)
+{
+  for(int handleIdx = 0; handleIdx < atlasHandles.count; handleIdx++)
+  {
+    unload_asset(atlasHandles[handleIdx]);
+  }
+  glFinish();
+
+  for(int atlasIdx = 0; atlasIdx < atlasHandles.count; atlasIdx++)
+  {
+    AssetHandle handle = request_asset(ASSET_TYPE_TEXTURE, ATLAS_TEXTURE_PATHS[atlasIdx]);
+    if(serial)
+    {
+      wait_for_assets(&handle, 1);
+    }
+  }
+  wait_for_assets(atlasHandles.elements, atlasHandles.count);
+  // The uploads count as well
+  glFinish();
+}
+
+/*
+* Hot Reloads read the loose files
+*/
+void bench_reload_every_asset(bool serial)
+{
+  for(int handleIdx = 0; handleIdx < assetHandles.count; handleIdx++)
+  {
+    reload_asset(assetHandles[handleIdx]);
+    if(serial)
+    {
+      wait_for_assets(&assetHandles[handleIdx], 1);
+    }
+  }
+  wait_for_assets(assetHandles.elements, assetHandles.count);
+  glFinish();
+}
+
+int bench_failed_assets()
+{
+  int failedCount = 0;
+  for(int handleIdx = 0; handleIdx < assetHandles.count; handleIdx++)
+  {
+    if(!get_asset(assetHandles[handleIdx]))
+    {
+      SM_ERROR("Failed to load Asset: %s", assetLoader.assets[assetHandles[handleIdx]].path);
+      failedCount++;
+    }
+  }
+
+  return failedCount;
+}
+
+void bench_print(const char* name, double serialMs, double concurrentMs)
+{
+  printf("  %-36s serial %8.2fms   concurrent %8.2fms   %5.2fx\n",
+         name, serialMs, concurrentMs, serialMs / concurrentMs);
+}
+
+int main()
+{
+  BumpAllocator transientStorage = make_bump_allocator(MB(50), "Transient Storage");
+  BumpAllocator persistentStorage = make_bump_allocator(MB(256), "Persistent Storage");
+  if(!engine_harness_init(&transientStorage, &persistentStorage))
+  {
+    return 1;
+  }
+
+  long long startNs = bench_time_ns();
+  bench_request_every_asset();
+  wait_for_assets(assetHandles.elements, assetHandles.count);
+  glFinish();
+  double firstLoadMs = (double)(bench_time_ns() - startNs) / 1000000.0;
+
+  if(bench_failed_assets())
+  {
+    engine_harness_shutdown();
+    return 1;
+  }
+
+  double atlasMs[2];
+  atlasMs[0] = bench_best_ms([]{ bench_request_atlases(true); });
+  atlasMs[1] = bench_best_ms([]{ bench_request_atlases(false); });
+
+  double reloadMs[2];
+  reloadMs[0] = bench_best_ms([]{ bench_reload_every_asset(true); });
+  reloadMs[1] = bench_best_ms([]{ bench_reload_every_asset(false); });
+
+  int failedCount = bench_failed_assets();
+  int workerCount = jobSystem.workerCount;
+  engine_harness_shutdown();
+
+  printf("%d Assets, %d Job Workers, best of %d runs\n",
+         assetHandles.count, workerCount, BENCH_REPEATS);
+  printf("  %-36s %8.2fms, concurrent, the Font was already loaded by gl_init()\n",
+         "first load out of assets.pak", firstLoadMs);
+  bench_print("Atlases out of assets.pak", atlasMs[0], atlasMs[1]);
+  bench_print("every Asset from the loose files", reloadMs[0], reloadMs[1]);
+
+  return failedCount? 1 : 0;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "schnitzel_lib.h"
+
+// Benchmarks that don't need the Platform Layer take their time from here
+#include <chrono>
+
+// #############################################################################
+//                           Bench Constants
+// #############################################################################
+// Every measurement is repeated, the fastest run is reported
+constexpr int BENCH_REPEATS = 5;
+
+// #############################################################################
+//                           Bench Functions
+// #############################################################################
+long long bench_time_ns()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Keeps the compiler from throwing away work whose result is never used
+template<typename T>
+void bench_keep(T* value)
+{
+  asm volatile("" : : "g"(value) : "memory");
+}
+
+/*
+* Runs benchFunction BENCH_REPEATS times and returns the fastest run in ms
+*/
+template<typename Function>
+double bench_best_ms(Function benchFunction)
+{
+  long long bestNs = 0;
+  for(int repeatIdx = 0; repeatIdx < BENCH_REPEATS; repeatIdx++)
+  {
+    long long startNs = bench_time_ns();
+    benchFunction();
+    long long timeNs = bench_time_ns() - startNs;
+    bestNs = (!repeatIdx || timeNs < bestNs)? timeNs : bestNs;
+  }
+
+  return (double)bestNs / 1000000.0;
+}
@@ -0,0 +1,205 @@
+#include "bench.h"
+
+#include <vector>
+
+// #############################################################################
+//                           Containers Bench Constants
+// #############################################################################
+// Append throughput of Array, DynArray, SmallArray and std::vector, once
+// for one big Array and once for lots of small ones, like per Entity lists
+constexpr int BENCH_BIG_COUNT = 1000000;
+constexpr int BENCH_SMALL_ARRAYS = 100000;
+constexpr int BENCH_SMALL_COUNT = 6;
+constexpr int BENCH_SMALL_INLINE = 8;
+
+// #############################################################################
+//                           Containers Bench Structs
+// #############################################################################
+// About the size of the plain data the Game keeps in lists
+struct BenchElement
+{
+  int a;
+  int b;
+  int c;
+};
+
+// #############################################################################
+//                           Containers Bench Globals
+// #############################################################################
+static Array<BenchElement, BENCH_BIG_COUNT> bigArray;
+static Array<BenchElement, BENCH_SMALL_COUNT> smallArrays[BENCH_SMALL_ARRAYS];
+static SmallArray<BenchElement, BENCH_SMALL_INLINE> smallArraysInline[BENCH_SMALL_ARRAYS];
+static SmallArray<BenchElement, BENCH_SMALL_COUNT / 2> smallArraysSpilled[BENCH_SMALL_ARRAYS];
+
+// #############################################################################
+//                           Containers Bench Functions
+// #############################################################################
+void bench_print(const char* name, double ms, int elementCount)
+{
+  printf("  %-34s %8.3fms  %7.2fns/add\n", name, ms, ms * 1000000.0 / elementCount);
+}
+
+int main()
+{
+  BumpAllocator arena = make_bump_allocator(MB(256), "Bench Arena");
+
+  printf("%d appends into one container\n", BENCH_BIG_COUNT);
+  {
+    double ms = bench_best_ms([]
+    {
+      bigArray.clear();
+      for(int idx = 0; idx < BENCH_BIG_COUNT; idx++)
+      {
+        bigArray.add({idx, idx, idx});
+      }
+      bench_keep(&bigArray);
+    });
+    bench_print("Array<T, N>", ms, BENCH_BIG_COUNT);
+
+    // Nothing else is allocated in between, so it grows in place
+    ms = bench_best_ms([&]
+    {
+      bump_allocator_reset(&arena);
+      DynArray<BenchElement> dynArray = make_dyn_array<BenchElement>(&arena);
+      for(int idx = 0; idx < BENCH_BIG_COUNT; idx++)
+      {
+        dynArray.add({idx, idx, idx});
+      }
+      bench_keep(dynArray.elements);
+    });
+    bench_print("DynArray (grows in place)", ms, BENCH_BIG_COUNT);
+
+    // Another allocation after every growth forces a copy each time
+    ms = bench_best_ms([&]
+    {
+      bump_allocator_reset(&arena);
+      DynArray<BenchElement> dynArray = make_dyn_array<BenchElement>(&arena);
+      for(int idx = 0; idx < BENCH_BIG_COUNT; idx++)
+      {
+        if(dynArray.count == dynArray.capacity)
+        {
+          dynArray.reserve(dynArray.capacity? dynArray.capacity * 2 : 8);
+          bump_alloc(&arena, 8);
+        }
+        dynArray.add({idx, idx, idx});
+      }
+      bench_keep(dynArray.elements);
+    });
+    bench_print("DynArray (copies on growth)", ms, BENCH_BIG_COUNT);
+
+    ms = bench_best_ms([&]
+    {
+      bump_allocator_reset(&arena);
+      DynArray<BenchElement> dynArray = make_dyn_array<BenchElement>(&arena, BENCH_BIG_COUNT);
+      for(int idx = 0; idx < BENCH_BIG_COUNT; idx++)
+      {
+        dynArray.add({idx, idx, idx});
+      }
+      bench_keep(dynArray.elements);
+    });
+    bench_print("DynArray (reserved)", ms, BENCH_BIG_COUNT);
+
+    ms = bench_best_ms([]
+    {
+      std::vector<BenchElement> vector;
+      for(int idx = 0; idx < BENCH_BIG_COUNT; idx++)
+      {
+        vector.push_back({idx, idx, idx});
+      }
+      bench_keep(vector.data());
+    });
+    bench_print("std::vector", ms, BENCH_BIG_COUNT);
+
+    ms = bench_best_ms([]
+    {
+      std::vector<BenchElement> vector;
+      vector.reserve(BENCH_BIG_COUNT);
+      for(int idx = 0; idx < BENCH_BIG_COUNT; idx++)
+      {
+        vector.push_back({idx, idx, idx});
+      }
+      bench_keep(vector.data());
+    });
+    bench_print("std::vector (reserved)", ms, BENCH_BIG_COUNT);
+  }
+
+  int smallElementCount = BENCH_SMALL_ARRAYS * BENCH_SMALL_COUNT;
+  printf("%d containers with %d appends each\n", BENCH_SMALL_ARRAYS, BENCH_SMALL_COUNT);
+  {
+    double ms = bench_best_ms([]
+    {
+      for(int arrayIdx = 0; arrayIdx < BENCH_SMALL_ARRAYS; arrayIdx++)
+      {
+        smallArrays[arrayIdx].clear();
+        for(int idx = 0; idx < BENCH_SMALL_COUNT; idx++)
+        {
+          smallArrays[arrayIdx].add({idx, idx, idx});
+        }
+      }
+      bench_keep(smallArrays);
+    });
+    bench_print("Array<T, N>", ms, smallElementCount);
+
+    ms = bench_best_ms([]
+    {
+      for(int arrayIdx = 0; arrayIdx < BENCH_SMALL_ARRAYS; arrayIdx++)
+      {
+        smallArraysInline[arrayIdx].clear();
+        for(int idx = 0; idx < BENCH_SMALL_COUNT; idx++)
+        {
+          smallArraysInline[arrayIdx].add({idx, idx, idx});
+        }
+      }
+      bench_keep(smallArraysInline);
+    });
+    bench_print("SmallArray (inline)", ms, smallElementCount);
+
+    ms = bench_best_ms([&]
+    {
+      bump_allocator_reset(&arena);
+      for(int arrayIdx = 0; arrayIdx < BENCH_SMALL_ARRAYS; arrayIdx++)
+      {
+        SmallArray<BenchElement, BENCH_SMALL_COUNT / 2>& smallArray = smallArraysSpilled[arrayIdx];
+        smallArray.clear();
+        smallArray.bumpAllocator = &arena;
+        for(int idx = 0; idx < BENCH_SMALL_COUNT; idx++)
+        {
+          smallArray.add({idx, idx, idx});
+        }
+      }
+      bench_keep(smallArraysSpilled);
+    });
+    bench_print("SmallArray (spills into the Arena)", ms, smallElementCount);
+
+    ms = bench_best_ms([&]
+    {
+      bump_allocator_reset(&arena);
+      for(int arrayIdx = 0; arrayIdx < BENCH_SMALL_ARRAYS; arrayIdx++)
+      {
+        DynArray<BenchElement> dynArray = make_dyn_array<BenchElement>(&arena);
+        for(int idx = 0; idx < BENCH_SMALL_COUNT; idx++)
+        {
+          dynArray.add({idx, idx, idx});
+        }
+        bench_keep(dynArray.elements);
+      }
+    });
+    bench_print("DynArray", ms, smallElementCount);
+
+    ms = bench_best_ms([]
+    {
+      for(int arrayIdx = 0; arrayIdx < BENCH_SMALL_ARRAYS; arrayIdx++)
+      {
+        std::vector<BenchElement> vector;
+        for(int idx = 0; idx < BENCH_SMALL_COUNT; idx++)
+        {
+          vector.push_back({idx, idx, idx});
+        }
+        bench_keep(vector.data());
+      }
+    });
+    bench_print("std::vector", ms, smallElementCount);
+  }
+
+  return 0;
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+// The Engine like main.cpp builds it, for Tests that need the Asset Loader,
+// the Renderer and a real OpenGL context. Run them from the repository root
+// after the Cooker wrote assets.pak
+#include "schnitzel_lib.h"
+
+#include "input.h"
+
+#include "game.h"
+
+#include "sound.h"
+
+#include "ui.h"
+
+#define APIENTRY
+#define GL_GLEXT_PROTOTYPES
+#include "glcorearb.h"
+
+#include "platform.h"
+#ifdef _WIN32
+#include "win32_platform.cpp"
+#else // Linux
+#include "linux_platform.cpp"
+#endif
+
+#include "file_watcher.h"
+
+#include "asset_loader.h"
+
+#include "sound_loader.h"
+
+#include "gl_renderer.cpp"
+
+#include "bench.h"
+
+// #############################################################################
+//                           Engine Harness Functions
+// #############################################################################
+/*
+* Allocates the Engine state, opens a Window and initializes the Renderer
+* the same way main() does, the Game library and Audio are left out
+*/
+bool engine_harness_init(BumpAllocator* transientStorage, BumpAllocator* persistentStorage)
+{
+  input = (Input*)bump_alloc(persistentStorage, sizeof(Input), ALLOC_TAG_GAME);
+  renderData = (RenderData*)bump_alloc(persistentStorage, sizeof(RenderData), ALLOC_TAG_RENDER);
+  soundState = (SoundState*)bump_alloc(persistentStorage, sizeof(SoundState), ALLOC_TAG_SOUND);
+  stringInterner = (StringInterner*)bump_alloc(persistentStorage, sizeof(StringInterner));
+  if(!input || !renderData || !soundState || !stringInterner)
+  {
+    SM_ERROR("Failed to allocate the Engine state");
+    return false;
+  }
+  soundState->soundLookup = make_hash_map<unsigned int, int>(persistentStorage,
+                                                            MAX_CONCURRENT_SOUNDS,
+                                                            ALLOC_TAG_SOUND);
+  *stringInterner = make_string_interner(persistentStorage, MAX_INTERNED_STRINGS,
+                                         MAX_INTERNED_CHARS);
+  input->screenSize = {1280, 720};
+
+  job_system_init();
+
+  // Without it every Asset would come from the loose files
+  if(!load_asset_pack(ASSET_PACK_PATH))
+  {
+    SM_ERROR("No Asset Pack, run the Cooker from the repository root first");
+    job_system_shutdown();
+    return false;
+  }
+
+  if(!platform_init_file_watcher())
+  {
+    SM_ERROR("Failed to start the File Watcher");
+    job_system_shutdown();
+    return false;
+  }
+
+  gl_request_startup_assets();
+  if(!platform_create_window(input->screenSize.x, input->screenSize.y, "Schnitzel Motor Test") ||
+     !gl_init(transientStorage, persistentStorage))
+  {
+    SM_ERROR("Failed to initialize OpenGL");
+    asset_loader_shutdown();
+    platform_shutdown_file_watcher();
+    job_system_shutdown();
+    return false;
+  }
+
+  return true;
+}
+
+void engine_harness_shutdown()
+{
+  asset_loader_shutdown();
+  platform_shutdown_file_watcher();
+  job_system_shutdown();
+}
@@ -0,0 +1,223 @@
+#include "schnitzel_lib.h"
+
+#include "input.h"
+
+#include "game.h"
+
+#include "sound.h"
+
+#define APIENTRY
+#define GL_GLEXT_PROTOTYPES
+#include "glcorearb.h"
+
+#include "platform.h"
+#ifdef _WIN32
+#include "win32_platform.cpp"
+#else
+#include "linux_platform.cpp"
+#endif
+
+#include "frame_pacer.h"
+
+// #############################################################################
+//                           Frame Pacer Bench Constants
+// #############################################################################
+// Runs the same jittery workload on plain vsync, with a sleep to the deadline
+// and vsync off, and with the Frame Pacer on vsync. Compares how evenly the
+// frames are presented, and how old the input is by the time the frame is
+// presented. The display is simulated, a vblank every 1 / framesPerSecond.
+// Usage: frame_pacer_bench [framesPerSecond] [frameCount]
+constexpr int BENCH_DEFAULT_FPS = 120;
+// The pacer spends the first FRAME_PACER_HISTORY_FRAMES on plain vsync
+constexpr int BENCH_DEFAULT_FRAMES = 1200;
+
+// Simulated input, update and render, a random amount of busy work per frame
+constexpr long long BENCH_WORK_MIN_NS = 1000000;
+constexpr long long BENCH_WORK_MAX_NS = 3000000;
+// Every N frames the work takes a lot longer, like a level load or a hitch
+constexpr int BENCH_SPIKE_INTERVAL = 97;
+constexpr long long BENCH_SPIKE_NS = 6000000;
+
+// #############################################################################
+//                           Frame Pacer Bench Structs
+// #############################################################################
+struct BenchResult
+{
+  FrameStats stats;
+  int missedFrames;
+  // From the start of the work (input sampling) to the present
+  double latencyMsSum;
+};
+
+// #############################################################################
+//                           Frame Pacer Bench Functions
+// #############################################################################
+static unsigned int benchSeed = 12345;
+
+long long bench_work_ns(int frameIdx)
+{
+  benchSeed = benchSeed * 1664525 + 1013904223;
+  long long workNs = BENCH_WORK_MIN_NS +
+                     (benchSeed >> 8) % (BENCH_WORK_MAX_NS - BENCH_WORK_MIN_NS);
+  if(frameIdx % BENCH_SPIKE_INTERVAL == BENCH_SPIKE_INTERVAL - 1)
+  {
+    workNs += BENCH_SPIKE_NS;
+  }
+  return workNs;
+}
+
+// Spins, a sleep would hand the core to the scheduler and hide the work
+void bench_busy_work(long long workNs)
+{
+  long long endNs = platform_get_time_ns() + workNs;
+  while(platform_get_time_ns() < endNs)
+  {
+  }
+}
+
+/*
+* Blocks like swap_buffers() with vsync on, until the next vblank
+*/
+long long bench_wait_for_vblank(long long displayStartNs, long long refreshNs)
+{
+  long long now = platform_get_time_ns();
+  long long vblankNs = displayStartNs + ((now - displayStartNs) / refreshNs + 1) * refreshNs;
+  platform_sleep_until(vblankNs - FRAME_PACER_SPIN_NS);
+  while(platform_get_time_ns() < vblankNs)
+  {
+  }
+
+  return vblankNs;
+}
+
+void bench_add_frame(BenchResult* result, long long frameNs, long long latencyNs,
+                     long long targetFrameNs)
+{
+  frame_stats_add(&result->stats, (double)frameNs / 1000000.0);
+  result->latencyMsSum += (double)latencyNs / 1000000.0;
+  if(frameNs > targetFrameNs + targetFrameNs / 2)
+  {
+    result->missedFrames++;
+  }
+}
+
+/*
+* Does the work right after the last present, then waits for the vblank
+*/
+BenchResult bench_vsync(int framesPerSecond, int frameCount)
+{
+  BenchResult result = {};
+  result.stats.minMs = 1000.0;
+  benchSeed = 12345;
+
+  long long refreshNs = 1000000000LL / framesPerSecond;
+  long long displayStartNs = platform_get_time_ns();
+  long long lastPresentNs = displayStartNs;
+  for(int frameIdx = 0; frameIdx < frameCount; frameIdx++)
+  {
+    long long workStartNs = platform_get_time_ns();
+    bench_busy_work(bench_work_ns(frameIdx));
+    long long presentNs = bench_wait_for_vblank(displayStartNs, refreshNs);
+
+    bench_add_frame(&result, presentNs - lastPresentNs, presentNs - workStartNs, refreshNs);
+    lastPresentNs = presentNs;
+  }
+
+  return result;
+}
+
+/*
+* Does the work, then sleeps until the next deadline with vsync off,
+* the present tears wherever the display happens to be
+*/
+BenchResult bench_sleep_to_deadline(int framesPerSecond, int frameCount)
+{
+  BenchResult result = {};
+  result.stats.minMs = 1000.0;
+  benchSeed = 12345;
+
+  long long targetFrameNs = 1000000000LL / framesPerSecond;
+  long long lastPresentNs = platform_get_time_ns();
+  long long deadlineNs = lastPresentNs + targetFrameNs;
+  for(int frameIdx = 0; frameIdx < frameCount; frameIdx++)
+  {
+    long long workStartNs = platform_get_time_ns();
+    bench_busy_work(bench_work_ns(frameIdx));
+    platform_sleep_until(deadlineNs);
+
+    long long now = platform_get_time_ns();
+    bench_add_frame(&result, now - lastPresentNs, now - workStartNs, targetFrameNs);
+    lastPresentNs = now;
+
+    deadlineNs += targetFrameNs;
+    if(deadlineNs < now)
+    {
+      deadlineNs = now + targetFrameNs;
+    }
+  }
+
+  return result;
+}
+
+BenchResult bench_frame_pacer(int framesPerSecond, int frameCount)
+{
+  BenchResult result = {};
+  result.stats.minMs = 1000.0;
+  benchSeed = 12345;
+
+  long long refreshNs = 1000000000LL / framesPerSecond;
+  long long displayStartNs = platform_get_time_ns();
+  FramePacer framePacer = make_frame_pacer(framesPerSecond);
+  long long lastPresentNs = displayStartNs;
+  for(int frameIdx = 0; frameIdx < frameCount; frameIdx++)
+  {
+    frame_pacer_wait(&framePacer);
+    bench_busy_work(bench_work_ns(frameIdx));
+    frame_pacer_begin_present(&framePacer);
+    long long presentNs = bench_wait_for_vblank(displayStartNs, refreshNs);
+    frame_pacer_end_frame(&framePacer);
+
+    // The display shows the frame at the vblank, however late the swap returns
+    bench_add_frame(&result, presentNs - lastPresentNs,
+                    presentNs - framePacer.workStartNs, refreshNs);
+    lastPresentNs = presentNs;
+  }
+
+  return result;
+}
+
+void bench_print(char* name, BenchResult* result)
+{
+  double variance = frame_stats_variance(&result->stats);
+  printf("%-18s avg %7.3fms  variance %8.4fms^2  stddev %6.3fms  min %6.3fms  max %6.3fms  "
+         "missed %d  latency %.3fms\n",
+         name, result->stats.meanMs, variance, sqrt(variance),
+         result->stats.minMs, result->stats.maxMs, result->missedFrames,
+         result->latencyMsSum / result->stats.frameCount);
+}
+
+int main(int argc, char** argv)
+{
+  int framesPerSecond = argc > 1? atoi(argv[1]) : BENCH_DEFAULT_FPS;
+  int frameCount = argc > 2? atoi(argv[2]) : BENCH_DEFAULT_FRAMES;
+  if(framesPerSecond <= 0 || frameCount <= 1)
+  {
+    printf("Usage: frame_pacer_bench [framesPerSecond] [frameCount]\n");
+    return 1;
+  }
+
+  printf("%d frames at %d fps, work %.1f-%.1fms, %.1fms spike every %d frames\n",
+         frameCount, framesPerSecond,
+         (double)BENCH_WORK_MIN_NS / 1000000.0, (double)BENCH_WORK_MAX_NS / 1000000.0,
+         (double)BENCH_SPIKE_NS / 1000000.0, BENCH_SPIKE_INTERVAL);
+
+  BenchResult vsyncResult = bench_vsync(framesPerSecond, frameCount);
+  BenchResult sleepResult = bench_sleep_to_deadline(framesPerSecond, frameCount);
+  BenchResult pacerResult = bench_frame_pacer(framesPerSecond, frameCount);
+
+  bench_print("vsync", &vsyncResult);
+  bench_print("sleep, vsync off", &sleepResult);
+  bench_print("pacer on vsync", &pacerResult);
+
+  return 0;
+}
@@ -0,0 +1,209 @@
+#include "bench.h"
+
+#include <string>
+#include <unordered_map>
+
+// #############################################################################
+//                           Hash Map Bench Constants
+// #############################################################################
+// Lookups of Assets, Sounds and Sprites by name, once through interned
+// IDs in a HashMap and once with std::unordered_map keyed by the String
+// or by the same IDs
+constexpr int BENCH_KEY_COUNT = 4096;
+constexpr int BENCH_LOOKUP_COUNT = 1 << 16;
+constexpr int BENCH_LOOKUP_ROUNDS = 20;
+// Random inserts, removes and finds, compared against std::unordered_map
+constexpr int BENCH_CHECK_OPERATIONS = 200000;
+constexpr int BENCH_CHECK_KEYS = 3000;
+
+// #############################################################################
+//                           Hash Map Bench Globals
+// #############################################################################
+static char keyStrings[BENCH_KEY_COUNT][64];
+static unsigned int keyIDs[BENCH_KEY_COUNT];
+// Indices into the keys above, in the order they are looked up
+static int lookupOrder[BENCH_LOOKUP_COUNT];
+
+static unsigned int benchSeed = 12345;
+
+// #############################################################################
+//                           Hash Map Bench Functions
+// #############################################################################
+unsigned int bench_random()
+{
+  benchSeed = benchSeed * 1664525 + 1013904223;
+  return benchSeed >> 8;
+}
+
+void bench_print(const char* name, double ms, int operationCount)
+{
+  printf("  %-40s %8.3fms  %7.2fns/op\n", name, ms, ms * 1000000.0 / operationCount);
+}
+
+/*
+* Runs the same random operations on a HashMap and a std::unordered_map,
+* they have to agree on every result
+*/
+bool bench_check_hash_map(BumpAllocator* arena)
+{
+  HashMap<unsigned int, int> hashMap = make_hash_map<unsigned int, int>(arena);
+  std::unordered_map<unsigned int, int> unorderedMap;
+  for(int operationIdx = 0; operationIdx < BENCH_CHECK_OPERATIONS; operationIdx++)
+  {
+    unsigned int key = bench_random() % BENCH_CHECK_KEYS;
+    switch(bench_random() % 3)
+    {
+      case 0:
+      {
+        hashMap.insert(key, operationIdx);
+        unorderedMap[key] = operationIdx;
+        break;
+      }
+      case 1:
+      {
+        if(hashMap.remove(key) != (unorderedMap.erase(key) > 0))
+        {
+          return false;
+        }
+        break;
+      }
+      case 2:
+      {
+        int* value = hashMap.find(key);
+        auto it = unorderedMap.find(key);
+        if((value != nullptr) != (it != unorderedMap.end()) || (value && *value != it->second))
+        {
+          return false;
+        }
+        break;
+      }
+    }
+  }
+
+  return hashMap.count == (int)unorderedMap.size();
+}
+
+int main()
+{
+  BumpAllocator arena = make_bump_allocator(MB(256), "Bench Arena");
+
+  if(!bench_check_hash_map(&arena))
+  {
+    SM_ERROR("HashMap and std::unordered_map disagree");
+    return 1;
+  }
+
+  for(int keyIdx = 0; keyIdx < BENCH_KEY_COUNT; keyIdx++)
+  {
+    sprintf(keyStrings[keyIdx], "assets/sounds/sound_%d.wav", keyIdx);
+  }
+  for(int lookupIdx = 0; lookupIdx < BENCH_LOOKUP_COUNT; lookupIdx++)
+  {
+    lookupOrder[lookupIdx] = bench_random() % BENCH_KEY_COUNT;
+  }
+
+  printf("Interning %d Strings\n", BENCH_KEY_COUNT);
+  {
+    double ms = bench_best_ms([&]
+    {
+      bump_allocator_reset(&arena);
+      StringInterner interner = make_string_interner(&arena, BENCH_KEY_COUNT, KB(256));
+      for(int keyIdx = 0; keyIdx < BENCH_KEY_COUNT; keyIdx++)
+      {
+        keyIDs[keyIdx] = intern_string(&interner, keyStrings[keyIdx]);
+      }
+      bench_keep(keyIDs);
+    });
+    bench_print("StringInterner", ms, BENCH_KEY_COUNT);
+
+    ms = bench_best_ms([]
+    {
+      std::unordered_map<std::string, unsigned int> stringIDs;
+      for(int keyIdx = 0; keyIdx < BENCH_KEY_COUNT; keyIdx++)
+      {
+        stringIDs.emplace(keyStrings[keyIdx], (unsigned int)stringIDs.size() + 1);
+      }
+      bench_keep(&stringIDs);
+    });
+    bench_print("std::unordered_map<std::string, id>", ms, BENCH_KEY_COUNT);
+  }
+
+  // The IDs of the last run are the ones the lookups use
+  bump_allocator_reset(&arena);
+  StringInterner interner = make_string_interner(&arena, BENCH_KEY_COUNT, KB(256));
+  for(int keyIdx = 0; keyIdx < BENCH_KEY_COUNT; keyIdx++)
+  {
+    keyIDs[keyIdx] = intern_string(&interner, keyStrings[keyIdx]);
+  }
+
+  HashMap<unsigned int, int> hashMap = make_hash_map<unsigned int, int>(&arena, BENCH_KEY_COUNT);
+  std::unordered_map<unsigned int, int> idMap;
+  std::unordered_map<std::string, int> stringMap;
+  for(int keyIdx = 0; keyIdx < BENCH_KEY_COUNT; keyIdx++)
+  {
+    hashMap.insert(keyIDs[keyIdx], keyIdx);
+    idMap[keyIDs[keyIdx]] = keyIdx;
+    stringMap[keyStrings[keyIdx]] = keyIdx;
+  }
+
+  int lookupCount = BENCH_LOOKUP_COUNT * BENCH_LOOKUP_ROUNDS;
+  printf("%d lookups into %d keys\n", lookupCount, BENCH_KEY_COUNT);
+  {
+    long long sum = 0;
+    double ms = bench_best_ms([&]
+    {
+      for(int roundIdx = 0; roundIdx < BENCH_LOOKUP_ROUNDS; roundIdx++)
+      {
+        for(int lookupIdx = 0; lookupIdx < BENCH_LOOKUP_COUNT; lookupIdx++)
+        {
+          sum += *hashMap.find(keyIDs[lookupOrder[lookupIdx]]);
+        }
+      }
+      bench_keep(&sum);
+    });
+    bench_print("HashMap<id, V>", ms, lookupCount);
+
+    ms = bench_best_ms([&]
+    {
+      for(int roundIdx = 0; roundIdx < BENCH_LOOKUP_ROUNDS; roundIdx++)
+      {
+        for(int lookupIdx = 0; lookupIdx < BENCH_LOOKUP_COUNT; lookupIdx++)
+        {
+          sum += idMap.find(keyIDs[lookupOrder[lookupIdx]])->second;
+        }
+      }
+      bench_keep(&sum);
+    });
+    bench_print("std::unordered_map<id, V>", ms, lookupCount);
+
+    // The name still has to be hashed, like looking up by path every frame
+    ms = bench_best_ms([&]
+    {
+      for(int roundIdx = 0; roundIdx < BENCH_LOOKUP_ROUNDS; roundIdx++)
+      {
+        for(int lookupIdx = 0; lookupIdx < BENCH_LOOKUP_COUNT; lookupIdx++)
+        {
+          unsigned int stringID = find_string_id(&interner, keyStrings[lookupOrder[lookupIdx]]);
+          sum += *hashMap.find(stringID);
+        }
+      }
+      bench_keep(&sum);
+    });
+    bench_print("find_string_id + HashMap<id, V>", ms, lookupCount);
+
+    ms = bench_best_ms([&]
+    {
+      for(int roundIdx = 0; roundIdx < BENCH_LOOKUP_ROUNDS; roundIdx++)
+      {
+        for(int lookupIdx = 0; lookupIdx < BENCH_LOOKUP_COUNT; lookupIdx++)
+        {
+          sum += stringMap.find(keyStrings[lookupOrder[lookupIdx]])->second;
+        }
+      }
+      bench_keep(&sum);
+    });
+    bench_print("std::unordered_map<std::string, V>", ms, lookupCount);
+  }
+
+  return 0;
+}
@@ -0,0 +1,164 @@
+#include "bench.h"
+
+// #############################################################################
+//                           Job System Bench Constants
+// #############################################################################
+// Runs synthetic Entity workloads with 1 to N Workers and reports the
+// speedup over a single Worker.
+// Usage: job_system_bench [maxWorkers], defaults to the core count
+constexpr int BENCH_LIGHT_ENTITIES = 200000;
+constexpr int BENCH_LIGHT_BATCH = 1024;
+constexpr int BENCH_HEAVY_ENTITIES = 20000;
+constexpr int BENCH_HEAVY_BATCH = 256;
+constexpr int BENCH_HEAVY_STEPS = 64;
+// Jobs that spawn and wait for their own Jobs, like a Scene graph update
+constexpr int BENCH_PARENT_JOBS = 64;
+constexpr int BENCH_CHILD_JOBS = 32;
+
+// #############################################################################
+//                           Job System Bench Structs
+// #############################################################################
+struct BenchEntity
+{
+  Vec2 pos;
+  Vec2 speed;
+  Vec2 target;
+  float health;
+  float cooldown;
+};
+
+// #############################################################################
+//                           Job System Bench Globals
+// #############################################################################
+static BenchEntity* entities;
+static std::atomic<int> childJobsRun;
+
+// #############################################################################
+//                           Job System Bench Functions
+// #############################################################################
+// Movement, a few flops per Entity, mostly bound by memory bandwidth
+void bench_update_light(void* data, int start, int end)
+{
+  float dt = *(float*)data;
+  for(int entityIdx = start; entityIdx < end; entityIdx++)
+  {
+    BenchEntity& entity = entities[entityIdx];
+    entity.pos.x += entity.speed.x * dt;
+    entity.pos.y += entity.speed.y * dt;
+    entity.cooldown = entity.cooldown > dt? entity.cooldown - dt : 0.0f;
+  }
+}
+
+// Steering towards a target, bound by the ALU
+void bench_update_heavy(void* data, int start, int end)
+{
+  float dt = *(float*)data;
+  for(int entityIdx = start; entityIdx < end; entityIdx++)
+  {
+    BenchEntity& entity = entities[entityIdx];
+    for(int stepIdx = 0; stepIdx < BENCH_HEAVY_STEPS; stepIdx++)
+    {
+      float angle = atan2f(entity.target.y - entity.pos.y, entity.target.x - entity.pos.x);
+      entity.speed.x += cosf(angle) * dt;
+      entity.speed.y += sinf(angle) * dt;
+      entity.pos.x += entity.speed.x * dt;
+      entity.pos.y += entity.speed.y * dt;
+    }
+  }
+}
+
+void bench_child_job(void* data)
+{
+  childJobsRun.fetch_add(1, std::memory_order_relaxed);
+}
+
+void bench_parent_job(void* data)
+{
+  Job jobs[BENCH_CHILD_JOBS];
+  for(int jobIdx = 0; jobIdx < BENCH_CHILD_JOBS; jobIdx++)
+  {
+    jobs[jobIdx] = {bench_child_job, nullptr};
+  }
+
+  JobCounter counter = {};
+  run_jobs(jobs, BENCH_CHILD_JOBS, &counter);
+  wait_for_counter(&counter);
+}
+
+void bench_nested_jobs()
+{
+  Job jobs[BENCH_PARENT_JOBS];
+  for(int jobIdx = 0; jobIdx < BENCH_PARENT_JOBS; jobIdx++)
+  {
+    jobs[jobIdx] = {bench_parent_job, nullptr};
+  }
+
+  JobCounter counter = {};
+  run_jobs(jobs, BENCH_PARENT_JOBS, &counter);
+  wait_for_counter(&counter);
+}
+
+void bench_reset_entities()
+{
+  for(int entityIdx = 0; entityIdx < BENCH_LIGHT_ENTITIES; entityIdx++)
+  {
+    BenchEntity& entity = entities[entityIdx];
+    entity = {};
+    entity.pos = {(float)(entityIdx % 640), (float)(entityIdx / 640)};
+    entity.speed = {1.0f, -1.0f};
+    entity.target = {320.0f, 180.0f};
+    entity.cooldown = 1.0f;
+  }
+}
+
+int main(int argc, char** argv)
+{
+  int maxWorkers = argc > 1? atoi(argv[1]) : (int)std::thread::hardware_concurrency();
+  maxWorkers = maxWorkers < 1? 1 : maxWorkers;
+  maxWorkers = maxWorkers > MAX_JOB_WORKERS? MAX_JOB_WORKERS : maxWorkers;
+
+  entities = (BenchEntity*)malloc(sizeof(BenchEntity) * BENCH_LIGHT_ENTITIES);
+  float dt = 1.0f / 60.0f;
+
+  printf("Workers  light (%dk Entities)   heavy (%dk Entities)   nested (%d x %d Jobs)\n",
+         BENCH_LIGHT_ENTITIES / 1000, BENCH_HEAVY_ENTITIES / 1000,
+         BENCH_PARENT_JOBS, BENCH_CHILD_JOBS);
+
+  double singleWorkerMs[3] = {};
+  for(int workerCount = 1; workerCount <= maxWorkers; workerCount++)
+  {
+    job_system_init(workerCount);
+    bench_reset_entities();
+    childJobsRun = 0;
+
+    double ms[3] = {};
+    ms[0] = bench_best_ms([&]
+    {
+      parallel_for(BENCH_LIGHT_ENTITIES, BENCH_LIGHT_BATCH, bench_update_light, &dt);
+    });
+    ms[1] = bench_best_ms([&]
+    {
+      parallel_for(BENCH_HEAVY_ENTITIES, BENCH_HEAVY_BATCH, bench_update_heavy, &dt);
+    });
+    ms[2] = bench_best_ms(bench_nested_jobs);
+
+    job_system_shutdown();
+
+    int expectedChildJobs = BENCH_REPEATS * BENCH_PARENT_JOBS * BENCH_CHILD_JOBS;
+    if(childJobsRun != expectedChildJobs)
+    {
+      SM_ERROR("Nested Jobs lost: %d of %d ran", childJobsRun.load(), expectedChildJobs);
+      return 1;
+    }
+
+    if(workerCount == 1)
+    {
+      memcpy(singleWorkerMs, ms, sizeof(ms));
+    }
+    printf("%7d  %8.3fms (%5.2fx)     %8.3fms (%5.2fx)     %8.3fms (%5.2fx)\n", workerCount,
+           ms[0], singleWorkerMs[0] / ms[0], ms[1], singleWorkerMs[1] / ms[1],
+           ms[2], singleWorkerMs[2] / ms[2]);
+  }
+
+  return 0;
+}
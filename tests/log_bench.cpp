@@ -0,0 +1,89 @@
+#include "bench.h"
+
+// #############################################################################
+//                           Log Bench Constants
+// #############################################################################
+// Cost of an SM_TRACE call on the calling thread, synchronous and through
+// the Logger thread. The log lines are thrown away, the results go to stderr
+constexpr int BENCH_BURST_CALLS = 512;
+constexpr int BENCH_BURSTS = 200;
+
+#ifdef _WIN32
+const char* NULL_DEVICE = "NUL";
+#else
+const char* NULL_DEVICE = "/dev/null";
+#endif
+
+// #############################################################################
+//                           Log Bench Functions
+// #############################################################################
+/*
+* Times bursts of calls, a frame logs a few lines and then the Logger
+* thread has time to catch up. The flush in between is not measured
+*/
+template<typename Function>
+double bench_ns_per_call(Function logFunction)
+{
+  long long totalNs = 0;
+  for(int burstIdx = 0; burstIdx < BENCH_BURSTS; burstIdx++)
+  {
+    long long startNs = bench_time_ns();
+    for(int callIdx = 0; callIdx < BENCH_BURST_CALLS; callIdx++)
+    {
+      logFunction(callIdx);
+    }
+    totalNs += bench_time_ns() - startNs;
+    log_flush();
+  }
+
+  return (double)totalNs / (BENCH_BURSTS * BENCH_BURST_CALLS);
+}
+
+void bench_print(const char* name, double syncNs, double asyncNs)
+{
+  fprintf(stderr, "  %-30s sync %7.1fns/call   async %7.1fns/call\n", name, syncNs, asyncNs);
+}
+
+int main()
+{
+  if(!freopen(NULL_DEVICE, "w", stdout))
+  {
+    fprintf(stderr, "Failed to redirect stdout to %s\n", NULL_DEVICE);
+    return 1;
+  }
+  // Like a terminal, every line is written out
+  setvbuf(stdout, nullptr, _IOLBF, KB(64));
+
+  char name[32] = "assets/sounds/jump.wav";
+  auto noArgs = [](int callIdx)
+  {
+    SM_TRACE("Frame done");
+  };
+  auto numbers = [](int callIdx)
+  {
+    SM_TRACE("Frame %d took %.2fms, %lld bytes", callIdx, 1.5f, 1LL << 40);
+  };
+  auto strings = [&](int callIdx)
+  {
+    SM_TRACE("Loaded %s from %s in %d ms", name, "assets.pak", callIdx);
+  };
+
+  double syncNs[3];
+  syncNs[0] = bench_ns_per_call(noArgs);
+  syncNs[1] = bench_ns_per_call(numbers);
+  syncNs[2] = bench_ns_per_call(strings);
+
+  log_init();
+  double asyncNs[3];
+  asyncNs[0] = bench_ns_per_call(noArgs);
+  asyncNs[1] = bench_ns_per_call(numbers);
+  asyncNs[2] = bench_ns_per_call(strings);
+  log_shutdown();
+
+  fprintf(stderr, "SM_TRACE, bursts of %d calls, line buffered stdout\n", BENCH_BURST_CALLS);
+  bench_print("no arguments", syncNs[0], asyncNs[0]);
+  bench_print("int, float, long long", syncNs[1], asyncNs[1]);
+  bench_print("two Strings and an int", syncNs[2], asyncNs[2]);
+
+  return 0;
+}
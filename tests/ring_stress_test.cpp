@@ -0,0 +1,182 @@
+#include "bench.h"
+
+// #############################################################################
+//                           Ring Stress Test Constants
+// #############################################################################
+// Pushes messages through SPSCRing and MPSCRing from several threads and
+// checks that every message arrives exactly once, unchanged and in order
+// per producer. build.sh also builds it with -fsanitize=thread.
+// Usage: ring_stress_test [messagesPerProducer]
+constexpr int STRESS_DEFAULT_MESSAGES = 200000;
+constexpr int STRESS_MAX_PRODUCERS = 8;
+// Tiny Rings are full or empty most of the time, big ones rarely
+constexpr int STRESS_SMALL_RING = 4;
+constexpr int STRESS_BIG_RING = 1024;
+// Starting close to the end of the index range also tests the wrap around
+constexpr unsigned int STRESS_WRAP_START = 0xFFFFFFFFu - 8191u;
+
+// #############################################################################
+//                           Ring Stress Test Structs
+// #############################################################################
+// Bigger than a word, so torn reads and writes show up in the check
+struct RingMessage
+{
+  unsigned int producer;
+  unsigned int sequence;
+  unsigned long long check;
+};
+
+// #############################################################################
+//                           Ring Stress Test Globals
+// #############################################################################
+static SPSCRing<RingMessage, STRESS_SMALL_RING> smallSPSCRing;
+static SPSCRing<RingMessage, STRESS_BIG_RING> bigSPSCRing;
+static MPSCRing<RingMessage, STRESS_SMALL_RING> smallMPSCRing;
+static MPSCRing<RingMessage, STRESS_BIG_RING> bigMPSCRing;
+
+// #############################################################################
+//                           Ring Stress Test Functions
+// #############################################################################
+RingMessage make_ring_message(unsigned int producer, unsigned int sequence)
+{
+  unsigned long long key = (unsigned long long)producer << 32 | sequence;
+  return {producer, sequence, hash_key(key)};
+}
+
+template<int N>
+void ring_reset(SPSCRing<RingMessage, N>* ring, unsigned int startIdx)
+{
+  ring->tail = startIdx;
+  ring->cachedHead = startIdx;
+  ring->head = startIdx;
+  ring->cachedTail = startIdx;
+}
+
+// startIdx has to be a multiple of N, then every slot's sequence is startIdx
+template<int N>
+void ring_reset(MPSCRing<RingMessage, N>* ring, unsigned int startIdx)
+{
+  ring->tail = startIdx;
+  ring->head = startIdx;
+  for(int slotIdx = 0; slotIdx < N; slotIdx++)
+  {
+    ring->slots[slotIdx].sequence = startIdx;
+  }
+}
+
+/*
+* Pushes from producerCount threads and pops on this one,
+* returns the number of messages that were lost, duplicated,
+* corrupted or out of order
+*/
+template<typename Ring>
+int ring_stress(Ring* ring, int producerCount, int messagesPerProducer)
+{
+  std::thread producers[STRESS_MAX_PRODUCERS];
+  for(int producerIdx = 0; producerIdx < producerCount; producerIdx++)
+  {
+    producers[producerIdx] = std::thread([=]
+    {
+      for(int sequence = 0; sequence < messagesPerProducer; sequence++)
+      {
+        while(!ring->push(make_ring_message(producerIdx, sequence)))
+        {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+
+  int errors = 0;
+  int nextSequence[STRESS_MAX_PRODUCERS] = {};
+  long long messagesLeft = (long long)producerCount * messagesPerProducer;
+  while(messagesLeft)
+  {
+    RingMessage message;
+    if(!ring->pop(&message))
+    {
+      std::this_thread::yield();
+      continue;
+    }
+    messagesLeft--;
+
+    RingMessage expected = make_ring_message(message.producer, message.sequence);
+    if(message.producer >= (unsigned int)producerCount || message.check != expected.check)
+    {
+      errors++;
+      continue;
+    }
+
+    if(message.sequence != (unsigned int)nextSequence[message.producer])
+    {
+      errors++;
+    }
+    nextSequence[message.producer] = message.sequence + 1;
+  }
+
+  for(int producerIdx = 0; producerIdx < producerCount; producerIdx++)
+  {
+    producers[producerIdx].join();
+    if(nextSequence[producerIdx] != messagesPerProducer)
+    {
+      errors++;
+    }
+  }
+
+  // Nothing may be left over
+  RingMessage message;
+  errors += ring->pop(&message);
+
+  return errors;
+}
+
+template<typename Ring>
+bool run_ring_stress(const char* name, Ring* ring, unsigned int startIdx,
+                     int producerCount, int messagesPerProducer)
+{
+  ring_reset(ring, startIdx);
+
+  long long startNs = bench_time_ns();
+  int errors = ring_stress(ring, producerCount, messagesPerProducer);
+  double ms = (double)(bench_time_ns() - startNs) / 1000000.0;
+
+  double messageCount = (double)producerCount * messagesPerProducer;
+  printf("  %-30s start %10u  %d producers  %8.2fms  %6.2f M/s  %s\n", name, startIdx,
+         producerCount, ms, messageCount / (ms * 1000.0), errors? "FAILED" : "ok");
+  if(errors)
+  {
+    SM_ERROR("%s: %d bad messages", name, errors);
+  }
+
+  return !errors;
+}
+
+int main(int argc, char** argv)
+{
+  int messagesPerProducer = argc > 1? atoi(argv[1]) : STRESS_DEFAULT_MESSAGES;
+  if(messagesPerProducer <= 0)
+  {
+    printf("Usage: ring_stress_test [messagesPerProducer]\n");
+    return 1;
+  }
+
+  bool passed = true;
+  unsigned int startIdxs[] = {0, STRESS_WRAP_START};
+  for(unsigned int startIdx : startIdxs)
+  {
+    passed &= run_ring_stress("SPSCRing<4>", &smallSPSCRing, startIdx, 1, messagesPerProducer);
+    passed &= run_ring_stress("SPSCRing<1024>", &bigSPSCRing, startIdx, 1, messagesPerProducer);
+
+    int producerCounts[] = {1, 2, 4, STRESS_MAX_PRODUCERS};
+    for(int producerCount : producerCounts)
+    {
+      passed &= run_ring_stress("MPSCRing<4>", &smallMPSCRing, startIdx,
+                                producerCount, messagesPerProducer / producerCount);
+      passed &= run_ring_stress("MPSCRing<1024>", &bigMPSCRing, startIdx,
+                                producerCount, messagesPerProducer / producerCount);
+    }
+  }
+
+  printf(passed? "All Rings passed\n" : "Rings FAILED\n");
+  return passed? 0 : 1;
+}
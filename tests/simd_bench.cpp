@@ -0,0 +1,210 @@
+#include "bench.h"
+
+// #############################################################################
+//                           SIMD Bench Constants
+// #############################################################################
+// Per element cost of the SIMD batch functions against calling the scalar
+// function for every element, and a check that both give the same results.
+// Build with -mavx2 to bench the AVX2 paths
+constexpr int BENCH_ELEMENTS = 4096;
+constexpr int BENCH_ROUNDS = 2000;
+constexpr float BENCH_LERP_T = 0.37f;
+
+// #############################################################################
+//                           SIMD Bench Globals
+// #############################################################################
+static float inputA[BENCH_ELEMENTS];
+static float inputB[BENCH_ELEMENTS];
+static float inputC[BENCH_ELEMENTS];
+static float inputD[BENCH_ELEMENTS];
+static float output0[BENCH_ELEMENTS];
+static float output1[BENCH_ELEMENTS];
+static float output2[BENCH_ELEMENTS];
+static float output3[BENCH_ELEMENTS];
+static IVec2 intInputA[BENCH_ELEMENTS];
+static IVec2 intInputB[BENCH_ELEMENTS];
+static IVec2 intOutput[BENCH_ELEMENTS];
+static Mat4 projections[BENCH_ELEMENTS];
+
+static unsigned int benchSeed = 12345;
+
+// #############################################################################
+//                           SIMD Bench Functions
+// #############################################################################
+int bench_random(int range)
+{
+  benchSeed = benchSeed * 1664525 + 1013904223;
+  return (int)((benchSeed >> 8) % range);
+}
+
+/*
+* Times BENCH_ROUNDS calls of both functions, returns the ns per element
+*/
+template<typename ScalarFunction, typename BatchFunction>
+void bench_compare(const char* name, int elementCount,
+                   ScalarFunction scalarFunction, BatchFunction batchFunction)
+{
+  auto run = [&](auto function)
+  {
+    return bench_best_ms([&]
+    {
+      for(int roundIdx = 0; roundIdx < BENCH_ROUNDS; roundIdx++)
+      {
+        function();
+        bench_keep(output0);
+      }
+    });
+  };
+
+  double scalarMs = run(scalarFunction);
+  double batchMs = run(batchFunction);
+  double scalarNs = scalarMs * 1000000.0 / ((double)BENCH_ROUNDS * elementCount);
+  double batchNs = batchMs * 1000000.0 / ((double)BENCH_ROUNDS * elementCount);
+  printf("  %-24s scalar %6.3fns/element   batch %6.3fns/element   %5.2fx\n",
+         name, scalarNs, batchNs, scalarNs / batchNs);
+}
+
+int check_results()
+{
+  int mismatches = 0;
+
+  lerp_batch(output0, inputA, inputB, BENCH_LERP_T, BENCH_ELEMENTS);
+  for(int idx = 0; idx < BENCH_ELEMENTS; idx++)
+  {
+    mismatches += output0[idx] != lerp(inputA[idx], inputB[idx], BENCH_LERP_T);
+  }
+
+  lerp_batch(intOutput, intInputA, intInputB, BENCH_LERP_T, BENCH_ELEMENTS);
+  for(int idx = 0; idx < BENCH_ELEMENTS; idx++)
+  {
+    IVec2 expected = lerp(intInputA[idx], intInputB[idx], BENCH_LERP_T);
+    mismatches += expected.x != intOutput[idx].x || expected.y != intOutput[idx].y;
+  }
+
+  Mat4 projection = orthographic_projection(-320.0f, 320.0f, -180.0f, 180.0f);
+  transform_points_batch(output0, output1, inputA, inputB, BENCH_ELEMENTS, projection);
+  for(int idx = 0; idx < BENCH_ELEMENTS; idx++)
+  {
+    Vec2 expected = transform_point(projection, {inputA[idx], inputB[idx]});
+    mismatches += expected.x != output0[idx] || expected.y != output1[idx];
+  }
+
+  build_aabbs_batch(output0, output1, output2, output3,
+                    inputA, inputB, inputC, inputD, BENCH_ELEMENTS);
+  for(int idx = 0; idx < BENCH_ELEMENTS; idx++)
+  {
+    float minX = inputA[idx] - inputC[idx] * 0.5f;
+    float minY = inputB[idx] - inputD[idx] * 0.5f;
+    mismatches += minX != output0[idx] || minY != output1[idx] ||
+                  minX + inputC[idx] != output2[idx] || minY + inputD[idx] != output3[idx];
+  }
+
+  orthographic_projection_batch(projections, inputA, inputC, inputD, inputB, BENCH_ELEMENTS);
+  for(int idx = 0; idx < BENCH_ELEMENTS; idx++)
+  {
+    Mat4 expected = orthographic_projection(inputA[idx], inputC[idx], inputD[idx], inputB[idx]);
+    mismatches += memcmp(&expected, &projections[idx], sizeof(Mat4)) != 0;
+  }
+
+  return mismatches;
+}
+
+int main()
+{
+#if defined(SIMD_AVX2)
+  printf("SIMD path: AVX2 + SSE2\n");
+#elif defined(SIMD_SSE2)
+  printf("SIMD path: SSE2\n");
+#else
+  printf("SIMD path: none, the batch functions run the scalar loop\n");
+#endif
+
+  for(int idx = 0; idx < BENCH_ELEMENTS; idx++)
+  {
+    inputA[idx] = (float)(bench_random(2000) - 1000) + 0.25f;
+    inputB[idx] = (float)(bench_random(2000) - 1000);
+    // Sizes, and the right/top of the projections, never equal left/bottom
+    inputC[idx] = inputA[idx] + (float)(bench_random(64) + 1);
+    inputD[idx] = inputB[idx] + (float)(bench_random(64) + 1);
+    intInputA[idx] = {bench_random(4000) - 2000, bench_random(4000) - 2000};
+    intInputB[idx] = {bench_random(4000) - 2000, bench_random(4000) - 2000};
+  }
+
+  int mismatches = check_results();
+  if(mismatches)
+  {
+    SM_ERROR("%d results of the batch functions differ from the scalar ones", mismatches);
+    return 1;
+  }
+
+  printf("%d elements, best of %d runs\n", BENCH_ELEMENTS, BENCH_REPEATS);
+
+  bench_compare("lerp float", BENCH_ELEMENTS, []
+  {
+    for(int idx = 0; idx < BENCH_ELEMENTS; idx++)
+    {
+      output0[idx] = lerp(inputA[idx], inputB[idx], BENCH_LERP_T);
+    }
+  }, []
+  {
+    lerp_batch(output0, inputA, inputB, BENCH_LERP_T, BENCH_ELEMENTS);
+  });
+
+  bench_compare("lerp IVec2", BENCH_ELEMENTS, []
+  {
+    for(int idx = 0; idx < BENCH_ELEMENTS; idx++)
+    {
+      intOutput[idx] = lerp(intInputA[idx], intInputB[idx], BENCH_LERP_T);
+    }
+    bench_keep(intOutput);
+  }, []
+  {
+    lerp_batch(intOutput, intInputA, intInputB, BENCH_LERP_T, BENCH_ELEMENTS);
+    bench_keep(intOutput);
+  });
+
+  Mat4 projection = orthographic_projection(-320.0f, 320.0f, -180.0f, 180.0f);
+  bench_compare("transform_point", BENCH_ELEMENTS, [&]
+  {
+    for(int idx = 0; idx < BENCH_ELEMENTS; idx++)
+    {
+      Vec2 point = transform_point(projection, {inputA[idx], inputB[idx]});
+      output0[idx] = point.x;
+      output1[idx] = point.y;
+    }
+  }, [&]
+  {
+    transform_points_batch(output0, output1, inputA, inputB, BENCH_ELEMENTS, projection);
+  });
+
+  bench_compare("AABBs", BENCH_ELEMENTS, []
+  {
+    for(int idx = 0; idx < BENCH_ELEMENTS; idx++)
+    {
+      output0[idx] = inputA[idx] - inputC[idx] * 0.5f;
+      output1[idx] = inputB[idx] - inputD[idx] * 0.5f;
+      output2[idx] = output0[idx] + inputC[idx];
+      output3[idx] = output1[idx] + inputD[idx];
+    }
+  }, []
+  {
+    build_aabbs_batch(output0, output1, output2, output3,
+                      inputA, inputB, inputC, inputD, BENCH_ELEMENTS);
+  });
+
+  bench_compare("orthographic_projection", BENCH_ELEMENTS, []
+  {
+    for(int idx = 0; idx < BENCH_ELEMENTS; idx++)
+    {
+      projections[idx] = orthographic_projection(inputA[idx], inputC[idx],
+                                                 inputD[idx], inputB[idx]);
+    }
+    bench_keep(projections);
+  }, []
+  {
+    orthographic_projection_batch(projections, inputA, inputC, inputD, inputB, BENCH_ELEMENTS);
+    bench_keep(projections);
+  });
+
+  return 0;
+}
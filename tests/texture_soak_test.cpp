@@ -0,0 +1,154 @@
+#include "engine_harness.h"
+
+#ifdef _WIN32
+#include <psapi.h>
+#endif
+
+// #############################################################################
+//                           Texture Soak Test Constants
+// #############################################################################
+// Hot Reloads every Atlas over and over through gl_render() and checks
+// that neither the live Textures nor the resident memory grow.
+// Needs a Window, run it from the repository root after the Cooker.
+// Usage: texture_soak_test [reloadCount]
+constexpr int SOAK_DEFAULT_RELOADS = 1000;
+// The first reloads cook the loose files and warm up the driver
+constexpr int SOAK_WARMUP_RELOADS = 3;
+constexpr int SOAK_REPORT_INTERVAL = 250;
+// Allocator and driver noise, a leaked Atlas per reload is far more than this
+constexpr long long SOAK_MAX_RSS_GROWTH_KB = 4096;
+// Texture names the live count looks at
+constexpr GLuint SOAK_MAX_TEXTURE_ID = 4096;
+
+// #############################################################################
+//                           Texture Soak Test Functions
+// #############################################################################
+long long soak_rss_kb()
+{
+#ifdef _WIN32
+  PROCESS_MEMORY_COUNTERS counters = {};
+  GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+  return (long long)counters.WorkingSetSize / KB(1);
+#else
+  long long sizePages = 0;
+  long long residentPages = 0;
+  FILE* statm = fopen("/proc/self/statm", "r");
+  if(statm)
+  {
+    if(fscanf(statm, "%lld %lld", &sizePages, &residentPages) != 2)
+    {
+      residentPages = 0;
+    }
+    fclose(statm);
+  }
+  return residentPages * (sysconf(_SC_PAGESIZE) / KB(1));
+#endif
+}
+
+int soak_live_textures()
+{
+  // Deleted Textures are gone once the driver is done with them
+  glFinish();
+
+  int textureCount = 0;
+  for(GLuint textureID = 1; textureID < SOAK_MAX_TEXTURE_ID; textureID++)
+  {
+    textureCount += glIsTexture(textureID) == GL_TRUE;
+  }
+
+  return textureCount;
+}
+
+/*
+* One frame with a change reported for every Atlas, like saving
+* all of them in the editor. Returns false if an Atlas failed to load
+*/
+bool soak_reload_atlases(BumpAllocator* transientStorage)
+{
+  for(int atlasIdx = 0; atlasIdx < ATLAS_COUNT; atlasIdx++)
+  {
+    fileWatcher.files[atlasResidency.atlases[atlasIdx].watchIdx].changed = true;
+  }
+
+  gl_state_begin_frame();
+  // Not BIT(ATLAS_COUNT) - 1, the macro has no outer parentheses
+  renderData->usedAtlases = (1 << ATLAS_COUNT) - 1;
+  gl_render(transientStorage);
+  bump_allocator_reset(transientStorage);
+
+  AssetHandle handles[ATLAS_COUNT];
+  for(int atlasIdx = 0; atlasIdx < ATLAS_COUNT; atlasIdx++)
+  {
+    handles[atlasIdx] = atlasResidency.atlases[atlasIdx].handle;
+  }
+  wait_for_assets(handles, ATLAS_COUNT);
+
+  for(int atlasIdx = 0; atlasIdx < ATLAS_COUNT; atlasIdx++)
+  {
+    if(!get_asset(handles[atlasIdx]))
+    {
+      SM_ERROR("Failed to reload Atlas: %s", ATLAS_TEXTURE_PATHS[atlasIdx]);
+      return false;
+    }
+  }
+
+  return true;
+}
+
+int main(int argc, char** argv)
+{
+  int reloadCount = argc > 1? atoi(argv[1]) : SOAK_DEFAULT_RELOADS;
+  if(reloadCount <= 0)
+  {
+    printf("Usage: texture_soak_test [reloadCount]\n");
+    return 1;
+  }
+
+  BumpAllocator transientStorage = make_bump_allocator(MB(50), "Transient Storage");
+  BumpAllocator persistentStorage = make_bump_allocator(MB(256), "Persistent Storage");
+  if(!engine_harness_init(&transientStorage, &persistentStorage))
+  {
+    return 1;
+  }
+
+  // The first frame requests the Atlases that aren't resident yet
+  bool passed = true;
+  for(int reloadIdx = 0; reloadIdx < SOAK_WARMUP_RELOADS && passed; reloadIdx++)
+  {
+    passed = soak_reload_atlases(&transientStorage);
+  }
+
+  int startTextures = soak_live_textures();
+  long long startRSS = soak_rss_kb();
+  printf("%d Atlases, %d live Textures, RSS %lldKB\n", ATLAS_COUNT, startTextures, startRSS);
+
+  int textures = startTextures;
+  long long rss = startRSS;
+  for(int reloadIdx = 1; reloadIdx <= reloadCount && passed; reloadIdx++)
+  {
+    passed = soak_reload_atlases(&transientStorage);
+    if(reloadIdx % SOAK_REPORT_INTERVAL == 0 || reloadIdx == reloadCount)
+    {
+      textures = soak_live_textures();
+      rss = soak_rss_kb();
+      printf("  reload %5d  %d live Textures  RSS %lldKB (%+lldKB)\n",
+             reloadIdx, textures, rss, rss - startRSS);
+    }
+  }
+
+  engine_harness_shutdown();
+
+  if(textures != startTextures)
+  {
+    SM_ERROR("Live Textures went from %d to %d", startTextures, textures);
+    passed = false;
+  }
+  if(rss - startRSS > SOAK_MAX_RSS_GROWTH_KB)
+  {
+    SM_ERROR("RSS grew by %lldKB, more than %lldKB", rss - startRSS, SOAK_MAX_RSS_GROWTH_KB);
+    passed = false;
+  }
+
+  printf(passed? "Texture Soak passed\n" : "Texture Soak FAILED\n");
+  return passed? 0 : 1;
+}